@@ -2,6 +2,7 @@
 """
 绘制热力图脚本
 输入 CSV 文件，输出两张热力图（sub_graphs_rate 和 incomplete_graphs_rate）
+CSV 含有置信区间列（*_ci_low / *_ci_high）时，格子中同时标注区间半宽
 """
 
 import argparse
@@ -12,6 +13,28 @@ import os
 from pathlib import Path
 
 
+def build_annotations(df: pd.DataFrame, metric: str):
+    """
+    生成热力图格子的标注文本
+
+    Args:
+        df: CSV 数据
+        metric: 比例列名
+
+    Returns:
+        含置信区间列时返回 "均值±半宽" 形式的透视表，否则返回 True（直接显示数值）
+    """
+    low_col, high_col = f'{metric}_ci_low', f'{metric}_ci_high'
+    if low_col not in df.columns or high_col not in df.columns:
+        return True
+
+    half_width = (df[high_col] - df[low_col]) / 2
+    labels = df[metric].map('{:.1f}'.format) + '\n±' + half_width.map('{:.1f}'.format)
+    return df.assign(label=labels).pivot(index='node_error_rate',
+                                         columns='edge_error_rate',
+                                         values='label').values
+
+
 def plot_heatmap(csv_path: str, output_path: str = None):
     """
     读取 CSV 文件并绘制热力图
@@ -57,9 +80,10 @@ def plot_heatmap(csv_path: str, output_path: str = None):
     
     # 绘制 sub_graphs_rate 热力图
     plt.figure(figsize=(12, 8))
+    annot_sub = build_annotations(df, 'sub_graphs_rate')
     sns.heatmap(pivot_sub, 
-                annot=True,  # 不显示数值，因为数据点较多
-                fmt='.1f',
+                annot=annot_sub,
+                fmt='.1f' if annot_sub is True else '',
                 cmap='YlOrRd',
                 cbar_kws={'label': 'Sub Graphs Rate (%)'},
                 linewidths=0.5,
@@ -77,9 +101,10 @@ def plot_heatmap(csv_path: str, output_path: str = None):
     
     # 绘制 incomplete_graphs_rate 热力图
     plt.figure(figsize=(12, 8))
+    annot_incomplete = build_annotations(df, 'incomplete_graphs_rate')
     sns.heatmap(pivot_incomplete, 
-                annot=True,  # 不显示数值，因为数据点较多
-                fmt='.1f',
+                annot=annot_incomplete,
+                fmt='.1f' if annot_incomplete is True else '',
                 cmap='YlGnBu',
                 cbar_kws={'label': 'Incomplete Graphs Rate (%)'},
                 linewidths=0.5,
@@ -0,0 +1,56 @@
+/**
+ * @file chip_pipeline.cpp
+ * @brief 流式芯片流水线实现
+ *
+ * 实现按需生成芯片的协程和有界的按分数选择
+ */
+
+#include "chip_pipeline.h"
+#include "error_inject.h"
+#include "mesh.h"
+#include <algorithm>
+
+std::generator<GraphWithMetadata> chip_stream(ChipStreamConfig config) {
+  // 完整芯片只生成一次，之后每个芯片从它复制
+  const GraphWithMetadata blank = generate_mesh_bitset(config.mesh_size);
+  for (int64_t chip_idx = 0; chip_idx < config.num_chips; ++chip_idx) {
+    GraphWithMetadata g = blank;
+    chip_error_inject(g, config.node_error_rate, config.edge_error_rate,
+                      config.seed, config.cell_idx, chip_idx);
+    if (config.delete_isolated_nodes) {
+      g.delete_isolated_nodes();
+    }
+    co_yield std::move(g);
+  }
+}
+
+void TopKByScore::push(GraphWithMetadata &&g) {
+  if (capacity_ == 0) {
+    ++next_order_;
+    return;
+  }
+  Entry entry{g.score(), next_order_++, std::move(g)};
+  if (heap_.size() < capacity_) {
+    heap_.push_back(std::move(entry));
+    std::ranges::push_heap(heap_, better);
+    return;
+  }
+  if (better(entry, heap_.front())) {
+    std::ranges::pop_heap(heap_, better);
+    heap_.back() = std::move(entry);
+    std::ranges::push_heap(heap_, better);
+  }
+}
+
+std::vector<GraphWithMetadata> TopKByScore::take_sorted() {
+  std::ranges::sort(heap_, [](const Entry &a, const Entry &b) {
+    return a.score != b.score ? a.score < b.score : a.order < b.order;
+  });
+  std::vector<GraphWithMetadata> result;
+  result.reserve(heap_.size());
+  for (auto &entry : heap_) {
+    result.push_back(std::move(entry.graph));
+  }
+  heap_.clear();
+  return result;
+}
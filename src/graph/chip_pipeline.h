@@ -0,0 +1,75 @@
+/**
+ * @file chip_pipeline.h
+ * @brief 流式芯片流水线声明
+ *
+ * 生成 → 注入故障 → 过滤 → 输出 逐个芯片进行，不物化整批芯片：
+ * chip_stream 按需产生芯片，过滤直接用 std::views::filter，
+ * 需要排序时用 TopKByScore 只保留有界数量的芯片，内存与芯片总数无关
+ */
+
+#pragma once
+
+#include "mesh_data.h"
+#include <cstddef>
+#include <cstdint>
+#include <generator>
+#include <vector>
+
+/**
+ * @brief 芯片流配置
+ */
+struct ChipStreamConfig {
+  int mesh_size = 4;               // 网格大小 k（k x k）
+  int64_t num_chips = 0;           // 芯片数量
+  float node_error_rate = 0.0f;    // 节点错误率（0.0-1.0）
+  float edge_error_rate = 0.0f;    // 边错误率（0.0-1.0）
+  uint64_t seed = 42;              // 随机种子
+  int cell_idx = 0;                // 随机流的格子索引
+  bool delete_isolated_nodes = false; // 注入后删除孤立节点
+};
+
+/**
+ * @brief 按需产生注入了故障的芯片
+ * @param config 芯片流配置（按值保存在协程中）
+ * @return 芯片生成器，第 i 个芯片使用 chip_fault_rng(seed, k, cell_idx, i)
+ *
+ * 芯片使用位压缩后端并共享网格原型；每次只存在一个芯片，
+ * 取到的引用在生成器前进之前有效，需要保留时移动出去
+ */
+std::generator<GraphWithMetadata> chip_stream(ChipStreamConfig config);
+
+/**
+ * @brief 按分数保留最好的 K 个芯片
+ *
+ * 小顶堆保存当前最好的 K 个（分数高者优先，分数相同时先到者优先），
+ * 堆顶是其中最差的一个，新芯片比它好时替换。每个芯片 O(log K)，
+ * 内存 O(K)
+ */
+class TopKByScore {
+private:
+  struct Entry {
+    int score;
+    int64_t order; // 到达顺序，保证结果与分数相同时的处理顺序无关
+    GraphWithMetadata graph;
+  };
+
+  size_t capacity_;
+  int64_t next_order_ = 0;
+  std::vector<Entry> heap_;
+
+  static bool better(const Entry &a, const Entry &b) {
+    return a.score != b.score ? a.score > b.score : a.order < b.order;
+  }
+
+public:
+  explicit TopKByScore(size_t capacity) : capacity_(capacity) {}
+
+  // 加入一个芯片（不够好时直接丢弃）
+  void push(GraphWithMetadata &&g);
+
+  size_t size() const { return heap_.size(); }
+  int64_t num_pushed() const { return next_order_; }
+
+  // 取出保留的芯片，按分数升序（与 std::ranges::sort 按 score 排序一致）
+  std::vector<GraphWithMetadata> take_sorted();
+};
@@ -0,0 +1,290 @@
+/**
+ * @file conditional_yield.cpp
+ * @brief 条件良率表实现
+ *
+ * 实现条件概率表的构建（精确值、穷举和抽样）以及按二项分布混合的查询
+ */
+
+#include "conditional_yield.h"
+#include "error_inject.h"
+#include "fault_sampler.h"
+#include "mesh_batch.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+namespace {
+
+/**
+ * @brief 单个表项的计数结果
+ */
+struct EntryCounts {
+  int num_samples = 0;
+  int num_sub_graphs = 0;
+  int num_incomplete = 0;
+  bool exact = false;
+};
+
+// 组合数 C(n, k)，用浮点数表示以免溢出
+double combinations(int n, int k) {
+  return std::round(std::exp(std::lgamma(n + 1.0) - std::lgamma(k + 1.0) -
+                             std::lgamma(n - k + 1.0)));
+}
+
+// 按字典序生成下一个 k 元组合，已是最后一个时返回 false
+bool next_combination(std::vector<int> &combination, int n) {
+  int k = static_cast<int>(combination.size());
+  for (int i = k - 1; i >= 0; --i) {
+    if (combination[i] < n - k + i) {
+      ++combination[i];
+      for (int j = i + 1; j < k; ++j) {
+        combination[j] = combination[j - 1] + 1;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+// 错误率为 p 时故障数量超过返回值的概率不超过 tolerance
+int tail_bound(int n, double p, double tolerance) {
+  std::vector<double> pmf = binomial_pmf(n, p);
+  double cdf = 0.0;
+  for (int k = 0; k <= n; ++k) {
+    cdf += pmf[k];
+    if (1.0 - cdf <= tolerance) {
+      return k;
+    }
+  }
+  return n;
+}
+
+// 保证批量的大小和芯片数量，能复用时只 reset()
+void prepare_batch(MeshBatch &batch, int N, int num_chips) {
+  if (batch.size() != N || batch.num_chips() != num_chips) {
+    batch = MeshBatch(N, num_chips);
+  } else {
+    batch.reset();
+  }
+}
+
+// 统计整批的性质
+void count_properties(const MeshBatch &batch, EntryCounts &out) {
+  out.num_samples = batch.num_chips();
+  out.num_sub_graphs =
+      static_cast<int>(std::ranges::count(batch.has_subgraphs(), char{1}));
+  out.num_incomplete =
+      static_cast<int>(std::ranges::count(batch.is_full(), char{0}));
+}
+
+} // namespace
+
+/**
+ * @brief 二项分布概率质量
+ * @param n 试验次数
+ * @param p 成功概率
+ * @return 第 k 项为 P(X = k)
+ *
+ * 在对数空间计算，n 较大时也不会下溢为 NaN
+ */
+std::vector<double> binomial_pmf(int n, double p) {
+  std::vector<double> pmf(n + 1, 0.0);
+  if (p <= 0.0) {
+    pmf[0] = 1.0;
+    return pmf;
+  }
+  if (p >= 1.0) {
+    pmf[n] = 1.0;
+    return pmf;
+  }
+
+  double log_p = std::log(p);
+  double log_q = std::log1p(-p);
+  double log_n = std::lgamma(n + 1.0);
+  for (int k = 0; k <= n; ++k) {
+    pmf[k] = std::exp(log_n - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0) +
+                      k * log_p + (n - k) * log_q);
+  }
+  return pmf;
+}
+
+/**
+ * @brief 构建条件良率表
+ * @param config 配置
+ *
+ * 每个表项是一个独立任务，交给 TBB 并行执行；
+ * 第 (a, b) 项第 c 个芯片的故障来自 chip_fault_rng(seed, k, 表项序号, c)
+ */
+ConditionalYieldTable::ConditionalYieldTable(
+    const ConditionalYieldConfig &config)
+    : mesh_size_(config.mesh_size) {
+  const int N = mesh_size_;
+  const int V = N * N;
+  const int E = 2 * N * (N - 1);
+  const int samples = std::max(1, config.samples_per_entry);
+
+  max_node_faults_ =
+      tail_bound(V, config.max_node_error_rate, config.tail_tolerance);
+  max_edge_faults_ =
+      tail_bound(E, config.max_edge_error_rate, config.tail_tolerance);
+
+  size_t num_entries = entry_index(max_node_faults_, max_edge_faults_) + 1;
+  std::vector<EntryCounts> counts(num_entries);
+  tbb::enumerable_thread_specific<MeshBatch> scratch;
+
+  auto build_entry = [&](size_t entry) {
+    int a = static_cast<int>(entry / (max_edge_faults_ + 1));
+    int b = static_cast<int>(entry % (max_edge_faults_ + 1));
+    EntryCounts &out = counts[entry];
+
+    // 没有坏节点时网格没有桥：至多一条坏链路不会产生子图
+    if (a == 0 && b <= 1) {
+      out = EntryCounts{1, 0, b, true};
+      return;
+    }
+
+    MeshBatch &batch = scratch.local();
+    double num_patterns = combinations(V, a) * combinations(E, b);
+
+    if (num_patterns <= samples) {
+      // 穷举所有故障组合
+      prepare_batch(batch, N, static_cast<int>(num_patterns));
+      std::vector<int> nodes(a);
+      std::iota(nodes.begin(), nodes.end(), 0);
+      int chip = 0;
+      do {
+        std::vector<int> edges(b);
+        std::iota(edges.begin(), edges.end(), 0);
+        do {
+          for (int e : edges) {
+            batch.delete_edge_by_id(chip, e);
+          }
+          for (int v : nodes) {
+            batch.delete_node(chip, v);
+          }
+          ++chip;
+        } while (next_combination(edges, E));
+      } while (next_combination(nodes, V));
+      count_properties(batch, out);
+      out.exact = true;
+      return;
+    }
+
+    // 抽样估计：每个芯片不放回地抽取 b 条链路和 a 个节点
+    prepare_batch(batch, N, samples);
+    for (int c = 0; c < samples; ++c) {
+      Philox4x32 rng =
+          chip_fault_rng(config.seed, N, static_cast<int>(entry), c);
+      sample_fixed_count(E, b, rng, [&batch, c](int64_t e) {
+        batch.delete_edge_by_id(c, static_cast<int>(e));
+      });
+      sample_fixed_count(V, a, rng, [&batch, c](int64_t v) {
+        batch.delete_node(c, static_cast<int>(v));
+      });
+    }
+    count_properties(batch, out);
+  };
+
+  tbb::task_arena arena(config.num_threads > 0 ? config.num_threads
+                                               : tbb::task_arena::automatic);
+  arena.execute([&] {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_entries, 1),
+                      [&](const tbb::blocked_range<size_t> &range) {
+                        for (size_t e = range.begin(); e != range.end(); ++e) {
+                          build_entry(e);
+                        }
+                      });
+  });
+
+  sub_graphs_.resize(num_entries);
+  incomplete_.resize(num_entries);
+  exact_.resize(num_entries);
+  for (size_t e = 0; e < num_entries; ++e) {
+    auto total = static_cast<float>(counts[e].num_samples);
+    sub_graphs_[e] = counts[e].num_sub_graphs / total;
+    incomplete_[e] = counts[e].num_incomplete / total;
+    exact_[e] = counts[e].exact;
+  }
+}
+
+float ConditionalYieldTable::sub_graphs_probability(int a, int b) const {
+  return sub_graphs_[entry_index(std::clamp(a, 0, max_node_faults_),
+                                 std::clamp(b, 0, max_edge_faults_))];
+}
+
+float ConditionalYieldTable::incomplete_probability(int a, int b) const {
+  return incomplete_[entry_index(std::clamp(a, 0, max_node_faults_),
+                                 std::clamp(b, 0, max_edge_faults_))];
+}
+
+bool ConditionalYieldTable::is_exact(int a, int b) const {
+  if (a < 0 || a > max_node_faults_ || b < 0 || b > max_edge_faults_) {
+    return false;
+  }
+  return exact_[entry_index(a, b)];
+}
+
+/**
+ * @brief 给定错误率下的良率估计
+ * @param node_error_rate 节点错误率（0.0-1.0）
+ * @param edge_error_rate 边错误率（0.0-1.0）
+ * @return 良率估计（百分比）
+ *
+ * 每个节点、每条链路独立出错时，坏节点数和坏链路数服从二项分布，
+ * 结果为 sum_a sum_b P(a) P(b) P(性质 | a, b)
+ */
+YieldEstimate ConditionalYieldTable::estimate(float node_error_rate,
+                                              float edge_error_rate) const {
+  return sweep({node_error_rate}, {edge_error_rate}).front();
+}
+
+/**
+ * @brief 整个错误率网格的良率估计
+ * @param node_error_rates 节点错误率
+ * @param edge_error_rates 边错误率
+ * @return 按 node_error_rate、edge_error_rate 顺序排列的良率估计
+ *
+ * 每个错误率的二项分布只计算一次；超出表范围的故障数量取最近的表项
+ */
+std::vector<YieldEstimate>
+ConditionalYieldTable::sweep(const std::vector<float> &node_error_rates,
+                             const std::vector<float> &edge_error_rates) const {
+  const int V = mesh_size_ * mesh_size_;
+  const int E = 2 * mesh_size_ * (mesh_size_ - 1);
+
+  std::vector<std::vector<double>> edge_pmfs;
+  edge_pmfs.reserve(edge_error_rates.size());
+  for (float rate : edge_error_rates) {
+    edge_pmfs.push_back(binomial_pmf(E, rate));
+  }
+
+  std::vector<YieldEstimate> estimates;
+  estimates.reserve(node_error_rates.size() * edge_error_rates.size());
+  for (float node_rate : node_error_rates) {
+    std::vector<double> node_pmf = binomial_pmf(V, node_rate);
+    for (size_t i = 0; i < edge_error_rates.size(); ++i) {
+      const auto &edge_pmf = edge_pmfs[i];
+      double sub_graphs = 0.0;
+      double incomplete = 0.0;
+      for (int a = 0; a <= V; ++a) {
+        if (node_pmf[a] == 0.0) {
+          continue;
+        }
+        for (int b = 0; b <= E; ++b) {
+          double weight = node_pmf[a] * edge_pmf[b];
+          sub_graphs += weight * sub_graphs_probability(a, b);
+          incomplete += weight * incomplete_probability(a, b);
+        }
+      }
+      estimates.push_back(YieldEstimate{mesh_size_, node_rate,
+                                        edge_error_rates[i],
+                                        static_cast<float>(sub_graphs * 100),
+                                        static_cast<float>(incomplete * 100)});
+    }
+  }
+  return estimates;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file conditional_yield.h
+ * @brief 条件良率表声明
+ *
+ * 故障位置均匀随机时，芯片的性质只取决于故障数量的分布。
+ * 先对每个 (a 个坏节点, b 条坏链路) 估计一次性质的条件概率，
+ * 任意错误率网格都可以通过二项分布混合直接得到
+ */
+
+#pragma once
+
+#include "yield_sweep.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 条件良率表配置
+ *
+ * 表的范围由最大错误率和尾部容差决定：在最大错误率下，
+ * 故障数量超出表范围的概率不超过 tail_tolerance
+ */
+struct ConditionalYieldConfig {
+  int mesh_size = 4;                // 网格大小 k（k x k）
+  float max_node_error_rate = 0.1f; // 查询时会用到的最大节点错误率
+  float max_edge_error_rate = 0.1f; // 查询时会用到的最大边错误率
+  double tail_tolerance = 1e-6;     // 表范围之外允许的概率质量
+  int samples_per_entry = 4096;     // 每个表项的抽样芯片数量
+  uint64_t seed = 42;               // 随机种子
+  int num_threads = 0;              // 工作线程数，0 表示使用全部核心
+};
+
+/**
+ * @brief 条件良率表
+ *
+ * 表项 (a, b) 记录恰好 a 个节点、b 条链路出错（均匀随机、不放回）时
+ * has_subgraphs() 和 !is_full() 的概率，故障先注入链路再注入节点，
+ * 与 random_error_inject 一致。
+ * a = 0 且 b <= 1 的表项直接给出精确值（网格没有桥），所有组合数量不超过
+ * samples_per_entry 的表项穷举计算，其余表项在位切片批量上抽样估计
+ */
+class ConditionalYieldTable {
+private:
+  int mesh_size_ = 0;
+  int max_node_faults_ = 0; // 表中 a 的最大值
+  int max_edge_faults_ = 0; // 表中 b 的最大值
+  std::vector<float> sub_graphs_; // P(has_subgraphs | a, b)
+  std::vector<float> incomplete_; // P(!is_full | a, b)
+  std::vector<char> exact_;       // 表项是否精确
+
+  size_t entry_index(int a, int b) const {
+    return static_cast<size_t>(a) * (max_edge_faults_ + 1) + b;
+  }
+
+public:
+  explicit ConditionalYieldTable(const ConditionalYieldConfig &config);
+
+  int mesh_size() const { return mesh_size_; }
+  int max_node_faults() const { return max_node_faults_; }
+  int max_edge_faults() const { return max_edge_faults_; }
+
+  // 表项查询，超出范围时取最近的表项
+  float sub_graphs_probability(int a, int b) const;
+  float incomplete_probability(int a, int b) const;
+  bool is_exact(int a, int b) const;
+
+  // 按二项分布混合得到给定错误率下的良率估计
+  YieldEstimate estimate(float node_error_rate, float edge_error_rate) const;
+
+  // 整个错误率网格，顺序为 node_error_rate、edge_error_rate
+  std::vector<YieldEstimate>
+  sweep(const std::vector<float> &node_error_rates,
+        const std::vector<float> &edge_error_rates) const;
+};
+
+/**
+ * @brief 二项分布概率质量
+ * @param n 试验次数
+ * @param p 成功概率
+ * @return 长度为 n + 1 的向量，第 k 项为 P(X = k)
+ */
+std::vector<double> binomial_pmf(int n, double p);
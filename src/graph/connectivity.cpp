@@ -0,0 +1,104 @@
+/**
+ * @file connectivity.cpp
+ * @brief 离线连通性追踪实现
+ *
+ * 逆序并查集：从所有故障都注入后的状态出发，按失效时刻从晚到早把节点和链路
+ * 加回图中，每加回一个时刻就记录一次连通分量数量
+ */
+
+#include "connectivity.h"
+#include <boost/pending/disjoint_sets.hpp>
+#include <limits>
+#include <unordered_map>
+
+/**
+ * @brief 离线计算故障序列的连通分量轨迹
+ * @param g 初始图（已有的删除状态视为初始故障）
+ * @param faults 按注入顺序排列的故障序列
+ * @return 第 k 项为注入前 k 个故障后的连通分量数量
+ *
+ * 元素的失效时刻 j 表示它在第 j 个故障注入后消失，即只存在于状态 0..j 中；
+ * 链路的失效时刻取自身故障时刻与两端节点失效时刻的较小值
+ */
+std::vector<int> offline_component_trace(const GraphWithMetadata &g,
+                                         const std::vector<FaultEvent> &faults) {
+  constexpr int kNever = std::numeric_limits<int>::max();
+  const int num_faults = static_cast<int>(faults.size());
+  const int num_vertices = g.num_vertices();
+
+  // 节点失效时刻，初始已删除的节点记为 -1（永远不会加回）
+  std::vector<int> node_death(num_vertices, kNever);
+  for (int v = 0; v < num_vertices; ++v) {
+    if (!g.node_alive(v)) {
+      node_death[v] = -1;
+    }
+  }
+  for (int k = 0; k < num_faults; ++k) {
+    const auto &fault = faults[k];
+    if (fault.is_node && fault.source_idx >= 0 &&
+        fault.source_idx < num_vertices && node_death[fault.source_idx] > k) {
+      node_death[fault.source_idx] = k;
+    }
+  }
+
+  // 链路失效时刻，按 (小索引, 大索引) 建立查找表
+  std::vector<std::pair<int, int>> edges = g.collect_valid_edges();
+  std::unordered_map<int64_t, int> edge_index;
+  std::vector<int> edge_death(edges.size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    auto [source_idx, target_idx] = edges[i];
+    int low = std::min(source_idx, target_idx);
+    int high = std::max(source_idx, target_idx);
+    edge_index[static_cast<int64_t>(low) * num_vertices + high] =
+        static_cast<int>(i);
+    edge_death[i] = std::min(node_death[source_idx], node_death[target_idx]);
+  }
+  for (int k = 0; k < num_faults; ++k) {
+    const auto &fault = faults[k];
+    if (fault.is_node) {
+      continue;
+    }
+    int low = std::min(fault.source_idx, fault.target_idx);
+    int high = std::max(fault.source_idx, fault.target_idx);
+    auto it = edge_index.find(static_cast<int64_t>(low) * num_vertices + high);
+    if (it != edge_index.end()) {
+      edge_death[it->second] = std::min(edge_death[it->second], k);
+    }
+  }
+
+  // 按失效时刻分桶，kNever 放在最后一个桶（即最终状态）
+  std::vector<std::vector<int>> nodes_by_death(num_faults + 1);
+  std::vector<std::vector<int>> edges_by_death(num_faults + 1);
+  for (int v = 0; v < num_vertices; ++v) {
+    if (node_death[v] >= 0) {
+      nodes_by_death[std::min(node_death[v], num_faults)].push_back(v);
+    }
+  }
+  for (size_t i = 0; i < edges.size(); ++i) {
+    if (edge_death[i] >= 0) {
+      edges_by_death[std::min(edge_death[i], num_faults)].push_back(
+          static_cast<int>(i));
+    }
+  }
+
+  // 逆序加回：状态 k = 状态 k+1 加上失效时刻为 k 的元素
+  boost::disjoint_sets_with_storage<> sets(num_vertices);
+  int num_components = 0;
+  std::vector<int> trace(num_faults + 1);
+  for (int k = num_faults; k >= 0; --k) {
+    for (int v : nodes_by_death[k]) {
+      sets.make_set(v);
+      ++num_components;
+    }
+    for (int i : edges_by_death[k]) {
+      int root_source = sets.find_set(edges[i].first);
+      int root_target = sets.find_set(edges[i].second);
+      if (root_source != root_target) {
+        sets.link(root_source, root_target);
+        --num_components;
+      }
+    }
+    trace[k] = num_components;
+  }
+  return trace;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file connectivity.h
+ * @brief 离线连通性追踪声明
+ *
+ * 故障序列事先已知时，用逆序并查集一次求出每次注入后的连通分量数量
+ */
+
+#pragma once
+
+#include "mesh_data.h"
+#include <vector>
+
+/**
+ * @brief 故障事件
+ *
+ * 节点故障只使用 source_idx；链路故障使用 source_idx 和 target_idx
+ */
+struct FaultEvent {
+  bool is_node;   // true: 节点故障，false: 链路故障
+  int source_idx; // 节点索引 / 链路源节点索引
+  int target_idx; // 链路目标节点索引（节点故障时为 -1）
+
+  static FaultEvent node(int node_idx) { return {true, node_idx, -1}; }
+  static FaultEvent edge(int source_idx, int target_idx) {
+    return {false, source_idx, target_idx};
+  }
+};
+
+/**
+ * @brief 离线计算故障序列的连通分量轨迹
+ * @param g 初始图（已有的删除状态视为初始故障）
+ * @param faults 按注入顺序排列的故障序列
+ * @return 长度为 faults.size() + 1 的向量，第 k 项为注入前 k 个故障后
+ *         未删除节点的连通分量数量
+ *
+ * 不修改 g。等价于对 g 的副本逐个调用 delete_node / delete_edge 并在每次之后
+ * 查询 num_components()，但总代价只有一次近线性的并查集合并
+ */
+std::vector<int> offline_component_trace(const GraphWithMetadata &g,
+                                         const std::vector<FaultEvent> &faults);
@@ -7,6 +7,31 @@
 
 #include "error_inject.h"
 
+namespace {
+
+/**
+ * @brief 按独立伯努利试验遍历单个芯片的故障
+ * @param rng 芯片的随机流
+ * @param num_nodes 节点数量
+ * @param num_edges 边数量
+ * @param on_edge 边 ID 出错时调用
+ * @param on_node 节点索引出错时调用
+ *
+ * 先抽取边故障，再抽取节点故障，按几何间隔跳过未出错的元素；
+ * 两种后端消耗同样的随机数序列，因此注入完全相同的故障
+ */
+template <typename OnEdge, typename OnNode>
+void for_each_chip_fault(Philox4x32 &rng, int num_nodes, int num_edges,
+                         float node_error_rate, float edge_error_rate,
+                         OnEdge &&on_edge, OnNode &&on_node) {
+  sample_bernoulli(num_edges, edge_error_rate, rng,
+                   [&](int64_t e) { on_edge(static_cast<int>(e)); });
+  sample_bernoulli(num_nodes, node_error_rate, rng,
+                   [&](int64_t v) { on_node(static_cast<int>(v)); });
+}
+
+} // namespace
+
 /**
  * @brief 注入节点错误
  * @param g 要操作的图
@@ -74,70 +99,157 @@ void edge_error_inject(Graph &g, const int source_idx, const int target_idx) {
  * @param node_error_rate 节点错误率（0.0-1.0）
  * @param edge_error_rate 边错误率（0.0-1.0）
  * @param rng 随机数生成器
+ * @param mode 抽样方式
  *
- * 根据指定的错误率，随机选择节点和边进行错误注入
+ * 根据指定的错误率，随机选择节点和边进行错误注入。
+ * 故障位置由流式抽样按升序给出，时间和内存只与故障数量有关
  */
 void random_error_inject(std::vector<GraphWithMetadata> &graphs,
                          const float node_error_rate,
-                         const float edge_error_rate, std::mt19937 &rng) {
+                         const float edge_error_rate, std::mt19937 &rng,
+                         FaultSampling mode) {
+  if (graphs.empty()) {
+    return;
+  }
 
-  // 获取网格大小
-  int num_graphs = graphs.size(); // 图的数量
+  // 故障位置按芯片连续编号，总数用 64 位避免溢出
+  int64_t num_graphs = static_cast<int64_t>(graphs.size());
+  int num_nodes = graphs[0].num_vertices();
+  int num_edges = graphs[0].num_edges();
 
-  int num_nodes = boost::num_vertices(graphs[0].graph());
-  int num_edges = boost::num_edges(graphs[0].graph());
+  // 对边进行错误注入：流式抽样，不物化整个边集合
+  sample_faults(mode, num_graphs * num_edges, edge_error_rate, rng,
+                [&graphs, num_edges](int64_t idx) {
+                  int sub_idx = static_cast<int>(idx % num_edges);
+                  int64_t chip_idx = idx / num_edges;
 
-  [[maybe_unused]] int mesh_size = std::sqrt(num_nodes); // 拓扑大小 n * n
+                  // 通过边 ID 查找表常数时间定位端点，并删除它
+                  if (!graphs[chip_idx].delete_edge_by_id(sub_idx)) {
+                    LOG_ERROR("not found edge: {}", sub_idx);
+                  }
+                });
 
-  // 计算总的节点数和边数
-  int total_nodes = num_graphs * num_nodes;
-  int total_edges = num_graphs * num_edges;
+  // 对节点进行错误注入
+  sample_faults(mode, num_graphs * num_nodes, node_error_rate, rng,
+                [&graphs, num_nodes](int64_t idx) {
+                  int sub_idx = static_cast<int>(idx % num_nodes);
+                  int64_t chip_idx = idx / num_nodes;
+                  graphs[chip_idx].delete_node(sub_idx);
+                });
+}
 
-  int total_error_nodes =
-      static_cast<int>(std::round(total_nodes * node_error_rate));
-  int total_error_edges =
-      static_cast<int>(std::round(total_edges * edge_error_rate));
+/**
+ * @brief 随机错误注入（位切片批量版本）
+ * @param batch 批量网格
+ * @param node_error_rate 节点错误率（0.0-1.0）
+ * @param edge_error_rate 边错误率（0.0-1.0）
+ * @param rng 随机数生成器
+ * @param mode 抽样方式
+ *
+ * 抽样方式与 std::vector<GraphWithMetadata> 版本相同：先在所有芯片的边中
+ * 抽取故障，再在所有节点中抽取，故障直接清除对应通道的位
+ */
+void random_error_inject(MeshBatch &batch, const float node_error_rate,
+                         const float edge_error_rate, std::mt19937 &rng,
+                         FaultSampling mode) {
+  int64_t num_chips = batch.num_chips();
+  int num_nodes = batch.num_vertices();
+  int num_edges = batch.num_edges();
 
   // 对边进行错误注入
-  std::vector<int> error_edge_idx;
-  auto range =
-      std::views::iota(0, total_edges) | std::ranges::to<std::vector>();
-  std::ranges::sample(range, std::back_inserter(error_edge_idx),
-                      total_error_edges, rng);
-
-  std::ranges::for_each(error_edge_idx, [&graphs, num_edges](int idx) {
-    int sub_idx = idx % num_edges;
-    int chip_idx = idx / num_edges;
-
-    // 获取图中的所有边，找到指定的idx的边，并删除它
-    auto &g = graphs[chip_idx].graph();
-    auto edges = boost::edges(g);
-
-    auto found = std::ranges::find_if(
-        std::ranges::subrange(edges.first, edges.second),
-        [&g, sub_idx](auto edge) { return g[edge].id == sub_idx; });
-
-    if (found != edges.second) {
-      auto edge = *found;
-      // edge_error_inject(g, g[edge].source_idx, g[edge].target_idx);
-      graphs[chip_idx].delete_edge(g[edge].source_idx, g[edge].target_idx);
-    } else {
-      LOG_ERROR("not found edge: {}", sub_idx);
-    }
-  });
+  sample_faults(mode, num_chips * num_edges, edge_error_rate, rng,
+                [&batch, num_edges](int64_t idx) {
+                  batch.delete_edge_by_id(static_cast<int>(idx / num_edges),
+                                          static_cast<int>(idx % num_edges));
+                });
 
   // 对节点进行错误注入
-  std::vector<int> error_node_idx;
-  range = std::views::iota(0, total_nodes) | std::ranges::to<std::vector>();
-  std::ranges::sample(range, std::back_inserter(error_node_idx),
-                      total_error_nodes, rng);
+  sample_faults(mode, num_chips * num_nodes, node_error_rate, rng,
+                [&batch, num_nodes](int64_t idx) {
+                  batch.delete_node(static_cast<int>(idx / num_nodes),
+                                    static_cast<int>(idx % num_nodes));
+                });
+}
 
-  std::ranges::for_each(error_node_idx, [&graphs, num_nodes](int idx) {
-    int sub_idx = idx % num_nodes;
+/**
+ * @brief 获取单个芯片的故障随机流
+ * @param seed 随机种子
+ * @param mesh_size 网格大小
+ * @param cell_idx 扫描格子索引
+ * @param chip_idx 芯片在格子中的全局索引
+ * @return 计数器随机数生成器
+ *
+ * 密钥由种子和网格大小派生，计数器的其余三个字是格子索引和 64 位芯片索引
+ */
+Philox4x32 chip_fault_rng(uint64_t seed, int mesh_size, int cell_idx,
+                          int64_t chip_idx) {
+  uint64_t key = splitmix64(seed ^ splitmix64(static_cast<uint64_t>(mesh_size)));
+  uint64_t chip = static_cast<uint64_t>(chip_idx);
+  return Philox4x32(key, static_cast<uint32_t>(cell_idx),
+                    static_cast<uint32_t>(chip),
+                    static_cast<uint32_t>(chip >> 32));
+}
 
-    int chip_idx = idx / num_nodes;
+/**
+ * @brief 对单个芯片按独立伯努利试验注入错误
+ * @param g 要操作的图
+ * @param node_error_rate 节点错误率（0.0-1.0）
+ * @param edge_error_rate 边错误率（0.0-1.0）
+ * @param seed 随机种子
+ * @param cell_idx 扫描格子索引
+ * @param chip_idx 芯片在格子中的全局索引
+ */
+void chip_error_inject(GraphWithMetadata &g, const float node_error_rate,
+                       const float edge_error_rate, uint64_t seed,
+                       int cell_idx, int64_t chip_idx) {
+  const int N = static_cast<int>(g.graph_size());
+  Philox4x32 rng = chip_fault_rng(seed, N, cell_idx, chip_idx);
+
+  // 边 ID 覆盖完整网格的所有链路，已删除的链路再次命中时没有效果
+  for_each_chip_fault(
+      rng, N * N, 2 * N * (N - 1), node_error_rate, edge_error_rate,
+      [&g](int edge_id) { g.delete_edge_by_id(edge_id); },
+      [&g](int node_idx) { g.delete_node(node_idx); });
+}
 
-    // node_error_inject(graphs[chip_idx].graph_mut(), sub_idx);
-    graphs[chip_idx].delete_node(sub_idx);
-  });
+/**
+ * @brief 可复现的随机错误注入
+ * @param graphs 图向量
+ * @param node_error_rate 节点错误率（0.0-1.0）
+ * @param edge_error_rate 边错误率（0.0-1.0）
+ * @param seed 随机种子
+ * @param cell_idx 扫描格子索引
+ * @param first_chip 第一个图的全局芯片索引
+ */
+void random_error_inject(std::vector<GraphWithMetadata> &graphs,
+                         const float node_error_rate,
+                         const float edge_error_rate, uint64_t seed,
+                         int cell_idx, int64_t first_chip) {
+  for (size_t i = 0; i < graphs.size(); ++i) {
+    chip_error_inject(graphs[i], node_error_rate, edge_error_rate, seed,
+                      cell_idx, first_chip + static_cast<int64_t>(i));
+  }
 }
+
+/**
+ * @brief 可复现的随机错误注入（位切片批量版本）
+ * @param batch 批量网格
+ * @param node_error_rate 节点错误率（0.0-1.0）
+ * @param edge_error_rate 边错误率（0.0-1.0）
+ * @param seed 随机种子
+ * @param cell_idx 扫描格子索引
+ * @param first_chip 第一个芯片的全局索引
+ */
+void random_error_inject(MeshBatch &batch, const float node_error_rate,
+                         const float edge_error_rate, uint64_t seed,
+                         int cell_idx, int64_t first_chip) {
+  for (int c = 0; c < batch.num_chips(); ++c) {
+    Philox4x32 rng =
+        chip_fault_rng(seed, batch.size(), cell_idx, first_chip + c);
+    for_each_chip_fault(
+        rng, batch.num_vertices(), batch.num_edges(), node_error_rate,
+        edge_error_rate,
+        [&batch, c](int edge_id) { batch.delete_edge_by_id(c, edge_id); },
+        [&batch, c](int node_idx) { batch.delete_node(c, node_idx); });
+  }
+}
\ No newline at end of file
@@ -8,7 +8,11 @@
 #pragma once
 
 #include "common.h"
+#include "fault_sampler.h"
 #include "mesh.h"
+#include "mesh_batch.h"
+#include "philox.h"
+#include <cstdint>
 
 /**
  * @brief 注入节点错误
@@ -31,7 +35,80 @@ void edge_error_inject(Graph &g, const int source_idx, const int target_idx);
  * @param node_error_rate 节点错误率（0.0-1.0）
  * @param edge_error_rate 边错误率（0.0-1.0）
  * @param rng 随机数生成器
+ * @param mode 抽样方式（默认固定总故障数）
  */
 void random_error_inject(std::vector<GraphWithMetadata> &graphs,
                          const float node_error_rate,
-                         const float edge_error_rate, std::mt19937 &rng);
\ No newline at end of file
+                         const float edge_error_rate, std::mt19937 &rng,
+                         FaultSampling mode = FaultSampling::fixed_count);
+
+/**
+ * @brief 随机错误注入（位切片批量版本）
+ * @param batch 批量网格
+ * @param node_error_rate 节点错误率（0.0-1.0）
+ * @param edge_error_rate 边错误率（0.0-1.0）
+ * @param rng 随机数生成器
+ * @param mode 抽样方式（默认固定总故障数）
+ */
+void random_error_inject(MeshBatch &batch, const float node_error_rate,
+                         const float edge_error_rate, std::mt19937 &rng,
+                         FaultSampling mode = FaultSampling::fixed_count);
+
+/**
+ * @brief 获取单个芯片的故障随机流
+ * @param seed 随机种子
+ * @param mesh_size 网格大小
+ * @param cell_idx 扫描格子索引
+ * @param chip_idx 芯片在格子中的全局索引
+ * @return 只由这四个参数决定的计数器随机数生成器
+ *
+ * 不同芯片的随机流互不重叠，任何一个芯片都可以单独重新生成
+ */
+Philox4x32 chip_fault_rng(uint64_t seed, int mesh_size, int cell_idx,
+                          int64_t chip_idx);
+
+/**
+ * @brief 对单个芯片按独立伯努利试验注入错误
+ * @param g 要操作的图
+ * @param node_error_rate 节点错误率（0.0-1.0）
+ * @param edge_error_rate 边错误率（0.0-1.0）
+ * @param seed 随机种子
+ * @param cell_idx 扫描格子索引
+ * @param chip_idx 芯片在格子中的全局索引
+ *
+ * 每条边、每个节点各自以给定概率出错，随机数来自 chip_fault_rng
+ */
+void chip_error_inject(GraphWithMetadata &g, const float node_error_rate,
+                       const float edge_error_rate, uint64_t seed,
+                       int cell_idx, int64_t chip_idx);
+
+/**
+ * @brief 可复现的随机错误注入
+ * @param graphs 图向量，graphs[i] 是格子中的第 first_chip + i 个芯片
+ * @param node_error_rate 节点错误率（0.0-1.0）
+ * @param edge_error_rate 边错误率（0.0-1.0）
+ * @param seed 随机种子
+ * @param cell_idx 扫描格子索引
+ * @param first_chip 第一个图的全局芯片索引
+ *
+ * 逐芯片调用 chip_error_inject，结果与线程数和分块方式无关
+ */
+void random_error_inject(std::vector<GraphWithMetadata> &graphs,
+                         const float node_error_rate,
+                         const float edge_error_rate, uint64_t seed,
+                         int cell_idx, int64_t first_chip = 0);
+
+/**
+ * @brief 可复现的随机错误注入（位切片批量版本）
+ * @param batch 批量网格，第 c 个芯片是格子中的第 first_chip + c 个芯片
+ * @param node_error_rate 节点错误率（0.0-1.0）
+ * @param edge_error_rate 边错误率（0.0-1.0）
+ * @param seed 随机种子
+ * @param cell_idx 扫描格子索引
+ * @param first_chip 第一个芯片的全局索引
+ *
+ * 与 std::vector<GraphWithMetadata> 版本逐芯片注入完全相同的故障
+ */
+void random_error_inject(MeshBatch &batch, const float node_error_rate,
+                         const float edge_error_rate, uint64_t seed,
+                         int cell_idx, int64_t first_chip = 0);
\ No newline at end of file
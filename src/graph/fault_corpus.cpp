@@ -0,0 +1,338 @@
+/**
+ * @file fault_corpus.cpp
+ * @brief 二进制故障语料库格式实现
+ *
+ * 实现语料库的流式写入、mmap 读取以及与 .gv 文件之间的转换
+ */
+
+#include "fault_corpus.h"
+#include "mesh.h"
+#include "mesh_layout.h"
+#include "mesh_utils.h"
+#include "topology_reader.h"
+#include <cstring>
+#include <fcntl.h>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kCorpusMagic[8] = {'F', 'Y', 'C', 'O', 'R', 'P', 'U', 'S'};
+constexpr uint32_t kCorpusVersion = 1;
+
+// 按宽度读写小端整数（映射区域不保证对齐，统一用 memcpy）
+uint32_t load_id(const std::byte *p, int width) {
+  if (width == 2) {
+    uint16_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+  }
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+void put_id(std::byte *p, uint32_t value, int width) {
+  if (width == 2) {
+    auto narrow = static_cast<uint16_t>(value);
+    std::memcpy(p, &narrow, sizeof(narrow));
+  } else {
+    std::memcpy(p, &value, sizeof(value));
+  }
+}
+
+/**
+ * @brief 网格大小为 N 时使用的 ID 宽度
+ * @param N 网格大小
+ * @return 2 或 4；N 不合法或 ID 总数超出 4 字节时为 0
+ *
+ * ID 总数（节点数 + 链路数）不超过 65535 时使用 2 字节 ID。
+ * 写入和读取都由它决定宽度，读取时据此校验文件头
+ */
+int corpus_id_width(int64_t N) {
+  if (N <= 0 || N > std::numeric_limits<uint16_t>::max()) {
+    return 0;
+  }
+  const int64_t num_ids = N * N + 2 * N * (N - 1);
+  if (num_ids <= std::numeric_limits<uint16_t>::max()) {
+    return 2;
+  }
+  return num_ids <= std::numeric_limits<uint32_t>::max() ? 4 : 0;
+}
+
+void store_id(std::vector<std::byte> &out, uint32_t value, int width) {
+  size_t pos = out.size();
+  out.resize(pos + width);
+  put_id(out.data() + pos, value, width);
+}
+
+} // namespace
+
+ChipFaultView::ChipFaultView(const std::byte *record, int id_width)
+    : ids_(record + 2 * id_width), id_width_(id_width),
+      num_dead_nodes_(load_id(record, id_width)),
+      num_dead_links_(load_id(record + id_width, id_width)) {}
+
+int ChipFaultView::id_at(size_t k) const {
+  return static_cast<int>(load_id(ids_ + k * id_width_, id_width_));
+}
+
+//---------------------------------------------------------------
+/**
+ * @brief 创建语料库文件
+ * @param file_path 输出路径
+ * @param N 网格大小
+ *
+ * ID 宽度见 corpus_id_width，N 过大无法编码时抛出 std::invalid_argument
+ */
+CorpusWriter::CorpusWriter(const std::filesystem::path &file_path, int N)
+    : mesh_size_(N), id_width_(corpus_id_width(N)) {
+  if (id_width_ == 0) {
+    throw std::invalid_argument(
+        std::format("网格大小 {} 无法写入语料库", N));
+  }
+  out_.open(file_path, std::ios::binary | std::ios::trunc);
+  if (!out_) {
+    throw std::runtime_error("无法创建语料库文件: " + file_path.string());
+  }
+  write_header(0); // 占位，close() 时回填
+}
+
+CorpusWriter::~CorpusWriter() {
+  if (!closed_) {
+    close();
+  }
+}
+
+void CorpusWriter::write_header(uint64_t index_offset) {
+  CorpusHeader header{};
+  std::memcpy(header.magic, kCorpusMagic, sizeof(kCorpusMagic));
+  header.version = kCorpusVersion;
+  header.mesh_size = static_cast<uint16_t>(mesh_size_);
+  header.id_width = static_cast<uint16_t>(id_width_);
+  header.num_chips = offsets_.size();
+  header.index_offset = index_offset;
+  out_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+/**
+ * @brief 追加一个芯片
+ * @param bits 芯片状态
+ *
+ * 只记录已删除节点和两端都存活但不存在的链路，
+ * 已删除节点的相连链路在回放时由 delete_node 隐含
+ */
+void CorpusWriter::append(const MeshBitset &bits) {
+  const int V = bits.num_vertices();
+  const auto layout = mesh_layout(mesh_size_);
+
+  record_.clear();
+  store_id(record_, 0, id_width_);
+  store_id(record_, 0, id_width_);
+  uint32_t num_nodes = 0;
+  uint32_t num_links = 0;
+  bits.for_each_fault([&](int i) {
+    if (i < V) {
+      store_id(record_, i, id_width_);
+      ++num_nodes;
+      return;
+    }
+    auto [source_idx, target_idx] = layout->edge_endpoints[i - V];
+    if (bits.node_alive(source_idx) && bits.node_alive(target_idx)) {
+      store_id(record_, i - V, id_width_);
+      ++num_links;
+    }
+  });
+  // 回填记录开头的计数
+  put_id(record_.data(), num_nodes, id_width_);
+  put_id(record_.data() + id_width_, num_links, id_width_);
+
+  offsets_.push_back(static_cast<uint64_t>(out_.tellp()));
+  out_.write(reinterpret_cast<const char *>(record_.data()),
+             static_cast<std::streamsize>(record_.size()));
+}
+
+void CorpusWriter::append(const GraphWithMetadata &g) {
+  if (g.bitset() != nullptr) {
+    append(*g.bitset());
+  } else {
+    append(MeshBitset::from_graph(g.graph()));
+  }
+}
+
+void CorpusWriter::close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+
+  uint64_t index_offset = static_cast<uint64_t>(out_.tellp());
+  offsets_.push_back(index_offset); // 最后一个芯片的结束位置
+  out_.write(reinterpret_cast<const char *>(offsets_.data()),
+             static_cast<std::streamsize>(offsets_.size() * sizeof(uint64_t)));
+  offsets_.pop_back();
+
+  out_.seekp(0);
+  write_header(index_offset);
+  out_.close();
+}
+
+//---------------------------------------------------------------
+CorpusReader::CorpusReader(const std::filesystem::path &file_path) {
+  int fd = ::open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("无法打开语料库文件: " + file_path.string());
+  }
+  struct stat st{};
+  if (::fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(CorpusHeader)) {
+    ::close(fd);
+    throw std::runtime_error("语料库文件不完整: " + file_path.string());
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  void *mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    throw std::runtime_error("无法映射语料库文件: " + file_path.string());
+  }
+  data_ = static_cast<const std::byte *>(mapped);
+
+  std::memcpy(&header_, data_, sizeof(header_));
+  bool valid =
+      std::memcmp(header_.magic, kCorpusMagic, sizeof(kCorpusMagic)) == 0 &&
+      header_.version == kCorpusVersion &&
+      corpus_id_width(header_.mesh_size) != 0 &&
+      header_.id_width == corpus_id_width(header_.mesh_size) &&
+      header_.index_offset >= sizeof(CorpusHeader) &&
+      header_.index_offset <= size_ &&
+      header_.num_chips <
+          (size_ - header_.index_offset) / sizeof(uint64_t); // 索引有 num_chips + 1 项
+  if (!valid) {
+    ::munmap(const_cast<std::byte *>(data_), size_);
+    data_ = nullptr;
+    throw std::runtime_error("语料库文件格式不正确: " + file_path.string());
+  }
+  index_ = data_ + header_.index_offset;
+  ::madvise(const_cast<std::byte *>(data_), size_, MADV_RANDOM);
+}
+
+CorpusReader::~CorpusReader() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<std::byte *>(data_), size_);
+  }
+}
+
+uint64_t CorpusReader::offset(size_t i) const {
+  uint64_t value;
+  std::memcpy(&value, index_ + i * sizeof(uint64_t), sizeof(value));
+  return value;
+}
+
+/**
+ * @brief 第 i 个芯片的故障增量
+ * @param i 芯片下标
+ * @return 指向映射区域的视图
+ *
+ * 记录来自文件，使用前校验：下标在范围内、记录位于文件头和索引之间、
+ * 长度恰好为 (2 + 节点数 + 链路数) 个 ID、节点 ID < V、链路 ID < E，
+ * 任何一项不满足都抛出 std::runtime_error
+ */
+ChipFaultView CorpusReader::faults(size_t i) const {
+  if (i >= num_chips()) {
+    throw std::runtime_error(
+        std::format("芯片下标 {} 超出语料库范围（共 {} 个）", i, num_chips()));
+  }
+  const uint64_t begin = offset(i);
+  const uint64_t end = offset(i + 1);
+  const size_t width = header_.id_width;
+  if (begin < sizeof(CorpusHeader) || begin > end ||
+      end > header_.index_offset || end - begin < 2 * width) {
+    throw std::runtime_error(
+        std::format("语料库中第 {} 个芯片的偏移不正确: [{}, {})", i, begin, end));
+  }
+
+  ChipFaultView view(data_ + begin, header_.id_width);
+  const uint64_t num_ids = view.num_dead_nodes() + view.num_dead_links();
+  if ((end - begin) / width != 2 + num_ids || (end - begin) % width != 0) {
+    throw std::runtime_error(
+        std::format("语料库中第 {} 个芯片的记录长度与故障数量不一致", i));
+  }
+
+  const int V = mesh_size() * mesh_size();
+  const int E = mesh_layout(mesh_size())->num_edges();
+  for (size_t k = 0; k < view.num_dead_nodes(); ++k) {
+    if (view.dead_node(k) < 0 || view.dead_node(k) >= V) {
+      throw std::runtime_error(std::format(
+          "语料库中第 {} 个芯片的节点 ID {} 超出网格", i, view.dead_node(k)));
+    }
+  }
+  for (size_t k = 0; k < view.num_dead_links(); ++k) {
+    if (view.dead_link(k) < 0 || view.dead_link(k) >= E) {
+      throw std::runtime_error(std::format(
+          "语料库中第 {} 个芯片的链路 ID {} 超出网格", i, view.dead_link(k)));
+    }
+  }
+  return view;
+}
+
+GraphWithMetadata CorpusReader::load(size_t i) const {
+  const int N = mesh_size();
+  const auto layout = mesh_layout(N);
+  ChipFaultView view = faults(i);
+
+  MeshBitset bits(N);
+  for (size_t k = 0; k < view.num_dead_nodes(); ++k) {
+    bits.delete_node(view.dead_node(k));
+  }
+  for (size_t k = 0; k < view.num_dead_links(); ++k) {
+    auto [source_idx, target_idx] = layout->edge_endpoints[view.dead_link(k)];
+    bits.delete_edge(source_idx, target_idx);
+  }
+  return GraphWithMetadata(std::move(bits), mesh_prototype(N));
+}
+
+//---------------------------------------------------------------
+void write_corpus(const std::vector<GraphWithMetadata> &graphs,
+                  const std::filesystem::path &file_path) {
+  if (graphs.empty()) {
+    LOG_ERROR("没有芯片，不写入语料库: {}", file_path.string());
+    return;
+  }
+  CorpusWriter writer(file_path, static_cast<int>(graphs.front().graph_size()));
+  for (const auto &g : graphs) {
+    writer.append(g);
+  }
+  writer.close();
+}
+
+size_t import_corpus_gv(const std::filesystem::path &base_path,
+                        const std::filesystem::path &file_path, int mesh_size) {
+  std::vector<GraphWithMetadata> graphs = load_topology_batch(base_path, mesh_size);
+  if (graphs.empty()) {
+    LOG_ERROR("没有可导入的拓扑文件: {}", base_path.string());
+    return 0;
+  }
+  const int N = static_cast<int>(graphs.front().graph_size());
+  CorpusWriter writer(file_path, N);
+  for (const auto &g : graphs) {
+    if (static_cast<int>(g.graph_size()) != N) {
+      LOG_ERROR("跳过尺寸为 {} 的芯片，语料库尺寸为 {}", g.graph_size(), N);
+      continue;
+    }
+    writer.append(g);
+  }
+  writer.close();
+  return writer.num_chips();
+}
+
+void export_corpus_gv(const CorpusReader &reader,
+                      const std::filesystem::path &base_path,
+                      const int weight, const int pipeline_stage_delay) {
+  auto chips = std::views::iota(size_t{0}, reader.num_chips()) |
+               std::views::transform([&](size_t i) { return reader.load(i); });
+  generate_topology_stream(chips, base_path, weight, pipeline_stage_delay);
+}
@@ -0,0 +1,177 @@
+/**
+ * @file fault_corpus.h
+ * @brief 二进制故障语料库格式声明
+ *
+ * .gv 文件每次都重复整个网格结构，而一个芯片与完整网格只差几个故障。
+ * 语料库只保存一次网格大小，每个芯片只保存故障增量（已删除节点、
+ * 两端都存活但不存在的链路），并带有偏移索引，可以 mmap 后直接随机访问
+ *
+ * 文件布局（小端）：
+ *   文件头 32 字节：magic "FYCORPUS"、版本、网格大小、ID 宽度（2 或 4 字节）、
+ *                   芯片数量、索引偏移
+ *   芯片记录：节点数、链路数、节点 ID...、链路 ID...（均为 ID 宽度的整数）
+ *   索引：num_chips + 1 个 uint64 偏移，第 i 个芯片占 [offset[i], offset[i+1])
+ */
+
+#pragma once
+
+#include "mesh_data.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+/**
+ * @brief 语料库文件头
+ */
+struct CorpusHeader {
+  char magic[8];          // "FYCORPUS"
+  uint32_t version;       // 格式版本
+  uint16_t mesh_size;     // 网格大小 N
+  uint16_t id_width;      // 每个 ID 的字节数（2 或 4）
+  uint64_t num_chips;     // 芯片数量
+  uint64_t index_offset;  // 索引在文件中的偏移
+};
+static_assert(sizeof(CorpusHeader) == 32);
+
+/**
+ * @brief 单个芯片的故障增量（指向 mmap 区域，不复制）
+ */
+class ChipFaultView {
+private:
+  const std::byte *ids_ = nullptr; // 第一个节点 ID
+  int id_width_ = 2;
+  uint32_t num_dead_nodes_ = 0;
+  uint32_t num_dead_links_ = 0;
+
+  int id_at(size_t k) const;
+
+public:
+  ChipFaultView() = default;
+  ChipFaultView(const std::byte *record, int id_width);
+
+  size_t num_dead_nodes() const { return num_dead_nodes_; }
+  size_t num_dead_links() const { return num_dead_links_; }
+
+  // 第 k 个已删除节点 / 不存在链路的 ID（链路 ID 与 MeshLayout 一致）
+  int dead_node(size_t k) const { return id_at(k); }
+  int dead_link(size_t k) const { return id_at(num_dead_nodes_ + k); }
+};
+
+/**
+ * @brief 语料库写入器
+ *
+ * 芯片逐个追加写出，只在内存中保留偏移索引（每个芯片 8 字节），
+ * close()（或析构）时写入索引并回填文件头
+ */
+class CorpusWriter {
+private:
+  std::ofstream out_;
+  int mesh_size_;
+  int id_width_;
+  std::vector<uint64_t> offsets_;
+  std::vector<std::byte> record_; // 复用的记录缓冲区
+  bool closed_ = false;
+
+  void write_header(uint64_t index_offset);
+
+public:
+  /**
+   * @brief 创建语料库文件
+   * @param file_path 输出路径（已存在时覆盖）
+   * @param N 网格大小（所有芯片相同）
+   *
+   * ID 总数超出 4 字节时抛出 std::invalid_argument，
+   * 文件无法创建时抛出 std::runtime_error
+   */
+  CorpusWriter(const std::filesystem::path &file_path, int N);
+  ~CorpusWriter();
+
+  CorpusWriter(const CorpusWriter &) = delete;
+  CorpusWriter &operator=(const CorpusWriter &) = delete;
+
+  // 追加一个芯片（尺寸必须为 N）
+  void append(const MeshBitset &bits);
+  void append(const GraphWithMetadata &g);
+
+  size_t num_chips() const { return offsets_.size(); }
+
+  // 写入索引和文件头
+  void close();
+};
+
+/**
+ * @brief 语料库只读访问（mmap）
+ *
+ * 打开时只校验文件头和索引范围，芯片记录按需从映射区域读取，
+ * 读取时再校验该记录的偏移、长度和 ID 范围
+ */
+class CorpusReader {
+private:
+  const std::byte *data_ = nullptr;
+  size_t size_ = 0;
+  CorpusHeader header_{};
+  const std::byte *index_ = nullptr;
+
+  uint64_t offset(size_t i) const;
+
+public:
+  /**
+   * @brief 打开语料库
+   * @param file_path 语料库路径
+   *
+   * 文件无法打开或格式不正确时抛出 std::runtime_error，
+   * 包括 ID 宽度与写入器对该网格大小的选择不一致
+   */
+  explicit CorpusReader(const std::filesystem::path &file_path);
+  ~CorpusReader();
+
+  CorpusReader(const CorpusReader &) = delete;
+  CorpusReader &operator=(const CorpusReader &) = delete;
+
+  int mesh_size() const { return header_.mesh_size; }
+  size_t num_chips() const { return header_.num_chips; }
+
+  // 第 i 个芯片的故障增量，下标越界或记录损坏时抛出 std::runtime_error
+  ChipFaultView faults(size_t i) const;
+
+  // 在完整网格上回放第 i 个芯片的故障（位压缩后端，共享网格原型），
+  // 校验同 faults()
+  GraphWithMetadata load(size_t i) const;
+};
+
+/**
+ * @brief 把一批芯片写成语料库
+ * @param graphs 芯片（尺寸必须相同）
+ * @param file_path 输出路径
+ */
+void write_corpus(const std::vector<GraphWithMetadata> &graphs,
+                  const std::filesystem::path &file_path);
+
+/**
+ * @brief 把 .gv 文件目录导入为语料库
+ * @param base_path generate_topology_batch 的输出目录
+ * @param file_path 语料库输出路径
+ * @param mesh_size 网格大小 N（0 表示按第一个文件推断）
+ * @return 写入的芯片数量
+ *
+ * 芯片顺序与文件编号一致，尺寸与 N 不同或无法解析的文件记录错误后跳过
+ */
+size_t import_corpus_gv(const std::filesystem::path &base_path,
+                        const std::filesystem::path &file_path,
+                        int mesh_size = 0);
+
+/**
+ * @brief 把语料库导出为 .gv 文件
+ * @param reader 语料库
+ * @param base_path 输出目录，文件名为 graph_0.gv, graph_1.gv, ...
+ * @param weight 边权重（默认值为1）
+ * @param pipeline_stage_delay 流水线阶段延迟（默认值为1）
+ *
+ * 与对原始芯片调用 generate_topology_batch 的输出逐字节相同
+ */
+void export_corpus_gv(const CorpusReader &reader,
+                      const std::filesystem::path &base_path,
+                      const int weight = 1,
+                      const int pipeline_stage_delay = 1);
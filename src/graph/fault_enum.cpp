@@ -0,0 +1,129 @@
+/**
+ * @file fault_enum.cpp
+ * @brief 固定故障数的穷举实现
+ *
+ * 实现在相邻故障模式之间增量更新位压缩网格的穷举过程
+ */
+
+#include "fault_enum.h"
+#include "mesh_layout.h"
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief 穷举过程中的网格状态
+ *
+ * 记录每个节点 / 链路是否出错，恢复节点时只恢复未出错的相连链路
+ */
+class PatternState {
+private:
+  const MeshLayout &layout_;
+  MeshBitset bits_;
+  std::vector<char> node_failed_;
+  std::vector<char> edge_failed_;
+
+  void fail_node(int v) {
+    node_failed_[v] = 1;
+    bits_.delete_node(v);
+  }
+
+  void repair_node(int v) {
+    node_failed_[v] = 0;
+    bits_.restore_node(v);
+    const int N = layout_.n;
+    const int neighbors[] = {v % N > 0 ? v - 1 : -1,
+                             v % N < N - 1 ? v + 1 : -1, v - N, v + N};
+    for (int u : neighbors) {
+      int e = layout_.edge_id(v, u);
+      if (e >= 0 && !edge_failed_[e]) {
+        bits_.restore_edge(v, u); // 另一端已删除时不会恢复
+      }
+    }
+  }
+
+  void fail_edge(int e) {
+    edge_failed_[e] = 1;
+    auto [source_idx, target_idx] = layout_.edge_endpoints[e];
+    bits_.delete_edge(source_idx, target_idx);
+  }
+
+  void repair_edge(int e) {
+    edge_failed_[e] = 0;
+    auto [source_idx, target_idx] = layout_.edge_endpoints[e];
+    bits_.restore_edge(source_idx, target_idx);
+  }
+
+  // 从旧的升序集合变为新的升序集合，只处理差异部分
+  template <typename Fail, typename Repair>
+  static void move(const std::vector<int> &from, const std::vector<int> &to,
+                   Fail fail, Repair repair) {
+    size_t i = 0;
+    size_t j = 0;
+    while (i < from.size() || j < to.size()) {
+      if (j == to.size() || (i < from.size() && from[i] < to[j])) {
+        repair(from[i++]);
+      } else if (i == from.size() || to[j] < from[i]) {
+        fail(to[j++]);
+      } else {
+        ++i;
+        ++j;
+      }
+    }
+  }
+
+public:
+  explicit PatternState(const MeshLayout &layout)
+      : layout_(layout), bits_(layout.n),
+        node_failed_(layout.num_vertices(), 0),
+        edge_failed_(layout.num_edges(), 0) {}
+
+  const MeshBitset &bits() const { return bits_; }
+
+  void move_nodes(const std::vector<int> &from, const std::vector<int> &to) {
+    move(from, to, [this](int v) { fail_node(v); },
+         [this](int v) { repair_node(v); });
+  }
+
+  void move_edges(const std::vector<int> &from, const std::vector<int> &to) {
+    move(from, to, [this](int e) { fail_edge(e); },
+         [this](int e) { repair_edge(e); });
+  }
+};
+
+} // namespace
+
+FaultEnumStats enumerate_fault_patterns(const FaultEnumConfig &config,
+                                        const FaultPatternVisitor &visit) {
+  FaultEnumStats stats;
+  const auto layout = mesh_layout(config.mesh_size);
+  PatternState state(*layout);
+  FaultPattern pattern;
+
+  for_each_combination(
+      layout->num_vertices(), config.num_node_faults,
+      [&](const std::vector<int> &nodes) {
+        state.move_nodes(pattern.nodes, nodes);
+        pattern.nodes = nodes;
+
+        for_each_combination(
+            layout->num_edges(), config.num_edge_faults,
+            [&](const std::vector<int> &edges) {
+              state.move_edges(pattern.edges, edges);
+              pattern.edges = edges;
+              ++stats.num_patterns;
+
+              if (!config.use_symmetry) {
+                ++stats.num_classes;
+                visit(pattern, state.bits(), 1);
+                return;
+              }
+              SymmetryClass cls = classify_pattern(pattern, *layout);
+              if (cls.is_canonical) {
+                ++stats.num_classes;
+                visit(pattern, state.bits(), cls.orbit_size);
+              }
+            });
+      });
+  return stats;
+}
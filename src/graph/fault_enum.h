@@ -0,0 +1,136 @@
+/**
+ * @file fault_enum.h
+ * @brief 固定故障数的穷举声明
+ *
+ * 小网格上固定数量的节点 / 链路故障组合数量有限（4x4 网格删除 5 条链路只有
+ * C(24, 5) = 42504 种），可以全部枚举，得到精确结果而不是随机抽样的近似
+ */
+
+#pragma once
+
+#include "fault_pattern.h"
+#include "mesh_bitset.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief 按旋转门（revolving-door）顺序枚举组合
+ * @param n 总体大小
+ * @param k 组合大小
+ * @param visit 对每个组合调用一次，参数为升序的 k 个元素
+ *
+ * Knuth 算法 7.2.1.3R：相邻两个组合恰好交换一个元素，
+ * 调用方可以据此增量更新状态
+ */
+template <typename Visit> void for_each_combination(int n, int k, Visit &&visit) {
+  std::vector<int> combo;
+  if (k < 0 || k > n) {
+    return;
+  }
+  if (k == 0 || k == n) {
+    for (int i = 0; i < k; ++i) {
+      combo.push_back(i);
+    }
+    visit(combo);
+    return;
+  }
+  if (k == 1) {
+    combo.push_back(0);
+    for (int i = 0; i < n; ++i) {
+      combo[0] = i;
+      visit(combo);
+    }
+    return;
+  }
+
+  // c[1..k] 为当前组合，c[k + 1] = n 为哨兵
+  std::vector<int> c(k + 2);
+  for (int j = 1; j <= k; ++j) {
+    c[j] = j - 1;
+  }
+  c[k + 1] = n;
+  combo.resize(k);
+
+  for (;;) {
+    std::copy(c.begin() + 1, c.begin() + k + 1, combo.begin());
+    visit(combo);
+
+    // 简单情况：只移动 c[1]
+    if (k & 1) {
+      if (c[1] + 1 < c[2]) {
+        ++c[1];
+        continue;
+      }
+    } else if (c[1] > 0) {
+      --c[1];
+      continue;
+    }
+
+    // 依次尝试减小 / 增大 c[j]
+    bool increase = !(k & 1);
+    bool advanced = false;
+    for (int j = 2; j <= k;) {
+      if (!increase) {
+        if (c[j] >= j) {
+          c[j] = c[j - 1];
+          c[j - 1] = j - 2;
+          advanced = true;
+          break;
+        }
+      } else if (c[j] + 1 < c[j + 1]) {
+        c[j - 1] = c[j];
+        ++c[j];
+        advanced = true;
+        break;
+      }
+      ++j;
+      increase = !increase;
+    }
+    if (!advanced) {
+      return;
+    }
+  }
+}
+
+/**
+ * @brief 穷举配置
+ */
+struct FaultEnumConfig {
+  int mesh_size = 4;       // 网格大小 k（k x k）
+  int num_node_faults = 0; // 出错节点数量
+  int num_edge_faults = 0; // 出错链路数量
+  bool use_symmetry = true; // 只访问对称类的规范代表
+};
+
+/**
+ * @brief 穷举统计
+ */
+struct FaultEnumStats {
+  int64_t num_patterns = 0; // 全部故障组合数量 C(V, a) * C(E, b)
+  int64_t num_classes = 0;  // 实际访问的模式数量（开启对称剪枝时为对称类数量）
+};
+
+/**
+ * @brief 访问函数
+ *
+ * 参数依次为故障模式、应用该模式后的网格、该模式代表的组合数量
+ * （开启对称剪枝时为对称类大小，否则为 1）
+ */
+using FaultPatternVisitor =
+    std::function<void(const FaultPattern &, const MeshBitset &, int)>;
+
+/**
+ * @brief 穷举固定数量的节点和链路故障
+ * @param config 穷举配置
+ * @param visit 访问函数
+ * @return 统计信息
+ *
+ * 外层按旋转门顺序枚举出错节点，内层枚举出错链路；相邻模式之间只恢复 / 删除
+ * 发生变化的节点和链路，不重建网格。出错链路可以落在已删除节点上，
+ * 与节点、链路独立出错的模型一致。
+ * 开启对称剪枝时，非规范代表只更新网格状态，不调用 visit；
+ * 所有被访问模式的组合数量之和等于 num_patterns
+ */
+FaultEnumStats enumerate_fault_patterns(const FaultEnumConfig &config,
+                                        const FaultPatternVisitor &visit);
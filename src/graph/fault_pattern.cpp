@@ -0,0 +1,208 @@
+/**
+ * @file fault_pattern.cpp
+ * @brief 故障模式及其对称变换实现
+ *
+ * 实现故障模式的对称变换、规范代表判断、到位压缩网格的转换，
+ * 以及位压缩故障键的规范化、哈希和按对称去重
+ */
+
+#include "fault_pattern.h"
+#include "philox.h"
+#include <algorithm>
+#include <bit>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <unordered_map>
+
+namespace {
+
+// 对每个置位的下标调用一次（故障通常很稀疏）
+template <typename Visit>
+void for_each_set_bit(const std::vector<uint64_t> &words, Visit &&visit) {
+  for (size_t w = 0; w < words.size(); ++w) {
+    uint64_t word = words[w];
+    while (word != 0) {
+      visit(static_cast<int>(w * 64) + std::countr_zero(word));
+      word &= word - 1;
+    }
+  }
+}
+
+void set_key_bit(FaultKey &key, int i) {
+  key.words[i >> 6] |= uint64_t{1} << (i & 63);
+}
+
+} // namespace
+
+FaultPattern transform_pattern(const FaultPattern &pattern,
+                               const MeshLayout &layout, int symmetry) {
+  FaultPattern image;
+  image.nodes.reserve(pattern.nodes.size());
+  image.edges.reserve(pattern.edges.size());
+  for (int v : pattern.nodes) {
+    image.nodes.push_back(layout.node_symmetries[symmetry][v]);
+  }
+  for (int e : pattern.edges) {
+    image.edges.push_back(layout.edge_symmetries[symmetry][e]);
+  }
+  std::ranges::sort(image.nodes);
+  std::ranges::sort(image.edges);
+  return image;
+}
+
+/**
+ * @brief 判断故障模式是否为规范代表并计算对称类大小
+ * @param pattern 故障模式（升序）
+ * @param layout 网格布局
+ * @return 对称类信息
+ *
+ * 对称类大小 = 8 / 稳定子群大小，稳定子群即把模式映射为自身的变换
+ */
+SymmetryClass classify_pattern(const FaultPattern &pattern,
+                               const MeshLayout &layout) {
+  SymmetryClass result;
+  int stabilizer = 1;
+  for (int s = 1; s < MeshLayout::kNumSymmetries; ++s) {
+    FaultPattern image = transform_pattern(pattern, layout, s);
+    auto order = image <=> pattern;
+    if (order == 0) {
+      ++stabilizer;
+    } else if (order < 0) {
+      result.is_canonical = false;
+    }
+  }
+  result.orbit_size = MeshLayout::kNumSymmetries / stabilizer;
+  return result;
+}
+
+MeshBitset apply_pattern(const FaultPattern &pattern, int N) {
+  MeshBitset bits(N);
+  const auto layout = mesh_layout(N);
+  for (int e : pattern.edges) {
+    auto [source_idx, target_idx] = layout->edge_endpoints[e];
+    bits.delete_edge(source_idx, target_idx);
+  }
+  for (int v : pattern.nodes) {
+    bits.delete_node(v);
+  }
+  return bits;
+}
+
+uint64_t FaultKey::hash() const {
+  uint64_t h = splitmix64(static_cast<uint64_t>(mesh_size));
+  for (uint64_t word : words) {
+    h = splitmix64(h ^ word);
+  }
+  return h;
+}
+
+std::array<uint64_t, 2> FaultKey::hash128() const {
+  uint64_t h = hash();
+  // 第二路使用不同的初值和混合顺序
+  uint64_t g = splitmix64(0x6A09E667F3BCC909ULL + mesh_size);
+  for (size_t w = words.size(); w-- > 0;) {
+    g = splitmix64(g + words[w]);
+  }
+  return {h, g};
+}
+
+FaultKey fault_key(const MeshBitset &bits) {
+  const int N = bits.size();
+  FaultKey key;
+  key.mesh_size = N;
+  key.words.assign((N * N + 2 * N * (N - 1) + 63) / 64, 0);
+  bits.for_each_fault([&](int i) { set_key_bit(key, i); });
+  return key;
+}
+
+namespace {
+
+// 把 key 的像写入 image（复用 image 的存储）
+void transform_key_into(const FaultKey &key, const MeshLayout &layout,
+                        int symmetry, FaultKey &image) {
+  const int V = layout.num_vertices();
+  image.mesh_size = key.mesh_size;
+  image.words.assign(key.words.size(), 0);
+  for_each_set_bit(key.words, [&](int i) {
+    set_key_bit(image, i < V ? layout.node_symmetries[symmetry][i]
+                             : V + layout.edge_symmetries[symmetry][i - V]);
+  });
+}
+
+} // namespace
+
+FaultKey transform_key(const FaultKey &key, const MeshLayout &layout,
+                       int symmetry) {
+  FaultKey image;
+  transform_key_into(key, layout, symmetry, image);
+  return image;
+}
+
+/**
+ * @brief 故障键的规范形式
+ * @param key 故障键
+ * @param layout 网格布局
+ * @return 规范键
+ *
+ * 8 个像中按 words 字典序最小的一个；对称类大小 = 8 / 与输入相同的像的数量
+ */
+CanonicalFaultKey canonical_key(const FaultKey &key, const MeshLayout &layout) {
+  CanonicalFaultKey result{key, 0, 1};
+  int stabilizer = 1;
+  FaultKey image;
+  for (int s = 1; s < MeshLayout::kNumSymmetries; ++s) {
+    transform_key_into(key, layout, s, image);
+    if (image == key) {
+      ++stabilizer;
+    } else if (image < result.key) {
+      std::swap(result.key, image);
+      result.symmetry = s;
+    }
+  }
+  result.orbit_size = MeshLayout::kNumSymmetries / stabilizer;
+  return result;
+}
+
+CanonicalFaultKey canonical_key(const GraphWithMetadata &g) {
+  const int N = static_cast<int>(g.graph_size());
+  FaultKey key = g.bitset() != nullptr
+                     ? fault_key(*g.bitset())
+                     : fault_key(MeshBitset::from_graph(g.graph()));
+  return canonical_key(key, *mesh_layout(N));
+}
+
+/**
+ * @brief 按旋转 / 翻转对称去重
+ * @param graphs 芯片
+ * @param num_threads 线程数
+ * @return 对称类分组
+ *
+ * 规范键并行计算，分组按输入顺序串行进行，结果与线程数无关
+ */
+std::vector<SymmetryGroup>
+dedup_by_symmetry(const std::vector<GraphWithMetadata> &graphs,
+                  int num_threads) {
+  std::vector<FaultKey> keys(graphs.size());
+  tbb::task_arena arena(num_threads > 0 ? num_threads
+                                        : tbb::task_arena::automatic);
+  arena.execute([&] {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, graphs.size()),
+                      [&](const tbb::blocked_range<size_t> &range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                          keys[i] = canonical_key(graphs[i]).key;
+                        }
+                      });
+  });
+
+  std::vector<SymmetryGroup> groups;
+  std::unordered_map<FaultKey, size_t> group_of;
+  for (size_t i = 0; i < graphs.size(); ++i) {
+    auto [it, inserted] = group_of.try_emplace(keys[i], groups.size());
+    if (inserted) {
+      groups.push_back({i, 0, keys[i]});
+    }
+    ++groups[it->second].multiplicity;
+  }
+  return groups;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file fault_pattern.h
+ * @brief 故障模式及其对称变换声明
+ *
+ * 故障模式记录一个芯片上出错的节点和链路，正方形网格的 8 个对称变换
+ * （旋转、翻转）把一个故障模式映射为连通性完全相同的另一个故障模式。
+ * 位压缩键（FaultKey）取 8 个像中最小的一个作为规范形式，用于哈希和去重
+ */
+
+#pragma once
+
+#include "mesh_bitset.h"
+#include "mesh_data.h"
+#include "mesh_layout.h"
+#include <array>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief 故障模式
+ *
+ * 比较按 nodes、edges 的字典序进行，对称类中最小的一个称为规范代表
+ */
+struct FaultPattern {
+  std::vector<int> nodes; // 出错节点索引，升序
+  std::vector<int> edges; // 出错链路 ID（与 MeshLayout 一致），升序
+
+  auto operator<=>(const FaultPattern &) const = default;
+};
+
+/**
+ * @brief 故障模式所在对称类的信息
+ */
+struct SymmetryClass {
+  bool is_canonical = true; // 是否为对称类中字典序最小的模式
+  int orbit_size = 1;       // 对称类中不同模式的数量（1、2、4 或 8）
+};
+
+/**
+ * @brief 对故障模式做对称变换
+ * @param pattern 故障模式
+ * @param layout 网格布局
+ * @param symmetry 对称变换编号（0..7，见 MeshLayout::node_symmetries）
+ * @return 变换后的故障模式（升序）
+ */
+FaultPattern transform_pattern(const FaultPattern &pattern,
+                               const MeshLayout &layout, int symmetry);
+
+/**
+ * @brief 判断故障模式是否为规范代表并计算对称类大小
+ * @param pattern 故障模式（升序）
+ * @param layout 网格布局
+ * @return 对称类信息
+ */
+SymmetryClass classify_pattern(const FaultPattern &pattern,
+                               const MeshLayout &layout);
+
+/**
+ * @brief 在完整网格上应用故障模式
+ * @param pattern 故障模式
+ * @param N 网格大小（N x N）
+ * @return 删除了对应节点和链路的位压缩网格
+ */
+MeshBitset apply_pattern(const FaultPattern &pattern, int N);
+
+/**
+ * @brief 故障模式的位压缩键
+ *
+ * 由芯片的当前状态决定：前 V 位为已删除的节点，随后 E 位为不存在的链路
+ * （包括因节点删除而消失的链路）。状态相同的两个芯片键相同
+ */
+struct FaultKey {
+  int mesh_size = 0; // 不同尺寸的网格键不相等
+  std::vector<uint64_t> words;
+
+  auto operator<=>(const FaultKey &) const = default;
+
+  // 64 位哈希，用于哈希表
+  uint64_t hash() const;
+
+  // 128 位指纹，两路独立的 64 位哈希，适合跨批次比较
+  std::array<uint64_t, 2> hash128() const;
+};
+
+template <> struct std::hash<FaultKey> {
+  size_t operator()(const FaultKey &key) const { return key.hash(); }
+};
+
+/**
+ * @brief 规范化后的故障键
+ */
+struct CanonicalFaultKey {
+  FaultKey key;       // 8 个像中最小的键
+  int symmetry = 0;   // 把输入映射为 key 的对称变换编号
+  int orbit_size = 1; // 对称类中不同状态的数量
+};
+
+/**
+ * @brief 计算芯片当前状态的故障键
+ * @param bits 位压缩网格
+ * @return 故障键
+ */
+FaultKey fault_key(const MeshBitset &bits);
+
+/**
+ * @brief 对故障键做对称变换
+ * @param key 故障键
+ * @param layout 网格布局
+ * @param symmetry 对称变换编号（0..7）
+ * @return 变换后的故障键
+ */
+FaultKey transform_key(const FaultKey &key, const MeshLayout &layout,
+                       int symmetry);
+
+/**
+ * @brief 故障键的规范形式
+ * @param key 故障键
+ * @param layout 网格布局
+ * @return 8 个对称像中最小的键及对应的变换
+ */
+CanonicalFaultKey canonical_key(const FaultKey &key, const MeshLayout &layout);
+
+// 芯片当前状态的规范故障键（Boost Graph 后端会先转换为位压缩表示）
+CanonicalFaultKey canonical_key(const GraphWithMetadata &g);
+
+/**
+ * @brief 对称去重后的一组芯片
+ */
+struct SymmetryGroup {
+  size_t representative = 0; // 代表芯片在输入中的下标（该类第一次出现的位置）
+  int multiplicity = 0;      // 输入中属于该类的芯片数量
+  FaultKey key;              // 规范故障键
+};
+
+/**
+ * @brief 按旋转 / 翻转对称去重
+ * @param graphs 芯片（尺寸必须相同）
+ * @param num_threads 计算规范键的线程数，0 表示使用全部核心
+ * @return 每个对称类一组，顺序与代表在输入中的顺序一致
+ */
+std::vector<SymmetryGroup>
+dedup_by_symmetry(const std::vector<GraphWithMetadata> &graphs,
+                  int num_threads = 0);
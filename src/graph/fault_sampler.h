@@ -0,0 +1,243 @@
+/**
+ * @file fault_sampler.h
+ * @brief 流式故障抽样
+ *
+ * 在 [0, population) 中按升序逐个给出故障位置，不物化整个总体，
+ * 时间和内存只与抽中的数量有关
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+/**
+ * @brief 故障抽样方式
+ */
+enum class FaultSampling {
+  fixed_count, // 固定总故障数：round(总数 * 错误率) 个，不放回
+  bernoulli,   // 每个元素独立地以错误率出错
+};
+
+namespace fault_sampler_detail {
+
+// (0, 1) 区间的均匀双精度数，53 位精度，不会取到 0，可以直接取对数
+template <typename URBG> double uniform_open(URBG &rng) {
+  for (;;) {
+    double u = std::generate_canonical<double, 53>(rng);
+    if (u > 0.0) {
+      return u;
+    }
+  }
+}
+
+// Vitter 方法 A：剩余样本占比较高时逐个计算跳过长度
+template <typename URBG, typename Emit>
+void sample_method_a(int64_t population, int64_t count, int64_t base,
+                     URBG &rng, Emit &emit) {
+  double top = static_cast<double>(population - count);
+  double remaining = static_cast<double>(population);
+  int64_t position = base;
+
+  while (count >= 2) {
+    double v = uniform_open(rng);
+    int64_t skip = 0;
+    double quot = top / remaining;
+    while (quot > v) {
+      ++skip;
+      top -= 1.0;
+      remaining -= 1.0;
+      quot = quot * top / remaining;
+    }
+    position += skip;
+    emit(position++);
+    remaining -= 1.0;
+    --count;
+  }
+  if (count == 1) {
+    auto skip = static_cast<int64_t>(std::round(remaining) * uniform_open(rng));
+    emit(position + skip);
+  }
+}
+
+} // namespace fault_sampler_detail
+
+/**
+ * @brief 不放回地抽取固定数量的位置
+ * @param population 总体大小
+ * @param count 抽取数量（超过总体时抽取全部）
+ * @param rng 随机数生成器
+ * @param emit 按升序对每个抽中的位置调用一次
+ *
+ * Vitter 方法 D：直接生成相邻样本之间的跳过长度，期望时间 O(count)，
+ * 结果等价于在整个总体上做 std::ranges::sample
+ */
+template <typename URBG, typename Emit>
+void sample_fixed_count(int64_t population, int64_t count, URBG &rng,
+                        Emit &&emit) {
+  using namespace fault_sampler_detail;
+  if (count <= 0 || population <= 0) {
+    return;
+  }
+  if (count >= population) {
+    for (int64_t i = 0; i < population; ++i) {
+      emit(i);
+    }
+    return;
+  }
+
+  constexpr int64_t kAlphaInverse = 13; // 样本占比超过 1/13 时改用方法 A
+  int64_t n = count;
+  int64_t N = population;
+  int64_t position = 0;
+
+  double n_real = static_cast<double>(n);
+  double N_real = static_cast<double>(N);
+  double v_prime = std::exp(std::log(uniform_open(rng)) / n_real);
+  int64_t qu1 = N - n + 1;
+  int64_t threshold = kAlphaInverse * n;
+
+  while (n > 1 && threshold < N) {
+    double n_min1_inv = 1.0 / (n_real - 1.0);
+    int64_t skip = 0;
+    for (;;) {
+      double x = 0.0;
+      for (;;) {
+        x = N_real * (1.0 - v_prime);
+        skip = static_cast<int64_t>(x);
+        if (skip < qu1) {
+          break;
+        }
+        v_prime = std::exp(std::log(uniform_open(rng)) / n_real);
+      }
+
+      double u = uniform_open(rng);
+      double y1 = std::exp(std::log(u * N_real / static_cast<double>(qu1)) *
+                           n_min1_inv);
+      v_prime = y1 * (1.0 - x / N_real) *
+                (static_cast<double>(qu1) / static_cast<double>(qu1 - skip));
+      if (v_prime <= 1.0) {
+        break; // 快速接受
+      }
+
+      double y2 = 1.0;
+      double top = N_real - 1.0;
+      double bottom;
+      int64_t limit;
+      if (n - 1 > skip) {
+        bottom = N_real - n_real;
+        limit = N - skip;
+      } else {
+        bottom = N_real - 1.0 - static_cast<double>(skip);
+        limit = qu1;
+      }
+      for (int64_t t = N - 1; t >= limit; --t) {
+        y2 = y2 * top / bottom;
+        top -= 1.0;
+        bottom -= 1.0;
+      }
+      if (N_real / (N_real - x) >= y1 * std::exp(std::log(y2) * n_min1_inv)) {
+        v_prime = std::exp(std::log(uniform_open(rng)) * n_min1_inv);
+        break; // 精确检验后接受
+      }
+      v_prime = std::exp(std::log(uniform_open(rng)) / n_real);
+    }
+
+    position += skip;
+    emit(position++);
+    N = N - 1 - skip;
+    N_real = static_cast<double>(N);
+    --n;
+    n_real -= 1.0;
+    qu1 -= skip;
+    threshold -= kAlphaInverse;
+  }
+
+  if (n > 1) {
+    sample_method_a(N, n, position, rng, emit);
+  } else {
+    auto skip = static_cast<int64_t>(N_real * v_prime);
+    emit(position + skip);
+  }
+}
+
+/**
+ * @brief 每个位置独立地以给定概率抽中
+ * @param population 总体大小
+ * @param rate 抽中概率（0.0-1.0）
+ * @param rng 随机数生成器
+ * @param emit 按升序对每个抽中的位置调用一次
+ *
+ * 相邻两个抽中位置之间的间隔服从几何分布，直接按间隔跳过，
+ * 期望时间 O(population * rate)
+ */
+template <typename URBG, typename Emit>
+void sample_bernoulli(int64_t population, double rate, URBG &rng,
+                      Emit &&emit) {
+  using namespace fault_sampler_detail;
+  if (rate <= 0.0 || population <= 0) {
+    return;
+  }
+  if (rate >= 1.0) {
+    for (int64_t i = 0; i < population; ++i) {
+      emit(i);
+    }
+    return;
+  }
+
+  double log_q = std::log1p(-rate);
+  int64_t position = -1;
+  for (;;) {
+    double gap = std::floor(std::log(uniform_open(rng)) / log_q);
+    if (gap >= static_cast<double>(population - 1 - position)) {
+      return;
+    }
+    position += static_cast<int64_t>(gap) + 1;
+    emit(position);
+  }
+}
+
+/**
+ * @brief 按抽样方式抽取故障位置
+ * @param mode 抽样方式
+ * @param population 总体大小
+ * @param rate 错误率（0.0-1.0）
+ * @param rng 随机数生成器
+ * @param emit 按升序对每个故障位置调用一次
+ */
+template <typename URBG, typename Emit>
+void sample_faults(FaultSampling mode, int64_t population, double rate,
+                   URBG &rng, Emit &&emit) {
+  if (mode == FaultSampling::bernoulli) {
+    sample_bernoulli(population, rate, rng, emit);
+  } else {
+    auto count = static_cast<int64_t>(
+        std::llround(static_cast<double>(population) * rate));
+    sample_fixed_count(population, count, rng, emit);
+  }
+}
+
+/**
+ * @brief 伯努利抽样的对数似然比
+ * @param population 总体大小
+ * @param hits 抽中的数量
+ * @param rate 目标概率
+ * @param tilted_rate 实际抽样使用的概率
+ * @return log(P_rate(样本) / P_tilted(样本))，用于重要性抽样的权重
+ *
+ * 抽中的位置不影响似然比，只与数量有关
+ */
+inline double bernoulli_log_likelihood_ratio(int64_t population, int64_t hits,
+                                             double rate, double tilted_rate) {
+  if (rate == tilted_rate) {
+    return 0.0;
+  }
+  if (hits > 0 && rate <= 0.0) {
+    return -std::numeric_limits<double>::infinity();
+  }
+  double hit_term = hits > 0 ? hits * std::log(rate / tilted_rate) : 0.0;
+  return hit_term + static_cast<double>(population - hits) *
+                        (std::log1p(-rate) - std::log1p(-tilted_rate));
+}
@@ -0,0 +1,153 @@
+/**
+ * @file fixed_mesh.h
+ * @brief 固定尺寸网格的编译期特化内核
+ *
+ * 对 K = 2..8 的小网格，K * K 个节点恰好放进一个 uint64_t，
+ * 节点/链路掩码、边编号和邻居表都在编译期生成，
+ * 连通性、分数和孤立节点删除直接编译为单字位运算
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+inline constexpr int kFixedMeshMinSize = 2; // 特化的最小网格大小
+inline constexpr int kFixedMeshMaxSize = 8; // 特化的最大网格大小（8 * 8 = 64 位）
+
+/**
+ * @brief 固定尺寸网格
+ * @tparam K 网格大小（K x K）
+ *
+ * 掩码编址与 MeshBitset 相同（v = row * K + col）：
+ * - nodes   第 v 位：节点 v 存活
+ * - h_links 第 v 位：横向链路 v -- v+1 存在
+ * - v_links 第 v 位：纵向链路 v -- v+K 存在
+ */
+template <int K> struct FixedMesh {
+  static_assert(K >= kFixedMeshMinSize && K <= kFixedMeshMaxSize,
+                "FixedMesh 只支持 2..8 的网格大小");
+
+  static constexpr int kSize = K;
+  static constexpr int kNumVertices = K * K;
+  static constexpr int kNumEdges = 2 * K * (K - 1);
+
+  // 完整网格的三组掩码
+  static constexpr uint64_t kNodeMask =
+      kNumVertices == 64 ? ~uint64_t{0} : (uint64_t{1} << kNumVertices) - 1;
+  static constexpr uint64_t kHLinkMask = [] {
+    uint64_t mask = 0;
+    for (int v = 0; v < kNumVertices; ++v) {
+      if (v % K < K - 1) {
+        mask |= uint64_t{1} << v;
+      }
+    }
+    return mask;
+  }();
+  static constexpr uint64_t kVLinkMask = kNodeMask >> K;
+
+  // 边 ID -> <源节点, 目标节点>，编号与 MeshLayout 一致
+  static constexpr std::array<std::pair<int, int>, kNumEdges> kEdgeEndpoints =
+      [] {
+        std::array<std::pair<int, int>, kNumEdges> endpoints{};
+        int idx = 0;
+        for (int row = 0; row < K; ++row) {
+          for (int col = 0; col < K - 1; ++col, ++idx) {
+            endpoints[idx] = {row * K + col, row * K + col + 1};
+          }
+        }
+        for (int v = 0; v < K * (K - 1); ++v, ++idx) {
+          endpoints[idx] = {v, v + K};
+        }
+        return endpoints;
+      }();
+
+  // 节点 -> 完整网格中相邻节点的掩码
+  static constexpr std::array<uint64_t, kNumVertices> kNeighbors = [] {
+    std::array<uint64_t, kNumVertices> neighbors{};
+    for (auto [source_idx, target_idx] : kEdgeEndpoints) {
+      neighbors[source_idx] |= uint64_t{1} << target_idx;
+      neighbors[target_idx] |= uint64_t{1} << source_idx;
+    }
+    return neighbors;
+  }();
+
+  // 集合 s 沿现存链路向外扩展一步
+  static constexpr uint64_t expand(uint64_t s, uint64_t h_links,
+                                   uint64_t v_links) {
+    return s | ((s & h_links) << 1) | ((s >> 1) & h_links) |
+           ((s & v_links) << K) | ((s >> K) & v_links);
+  }
+
+  // 存在至少一条现存链路的节点
+  static constexpr uint64_t linked_nodes(uint64_t h_links, uint64_t v_links) {
+    return h_links | (h_links << 1) | v_links | (v_links << K);
+  }
+
+  // 度数为 0 的存活节点
+  static constexpr uint64_t isolated_nodes(uint64_t nodes, uint64_t h_links,
+                                           uint64_t v_links) {
+    return nodes & ~linked_nodes(h_links, v_links);
+  }
+
+  /**
+   * @brief 计算存活节点的连通分量数量
+   * @return 连通分量数量，没有存活节点时返回 0
+   *
+   * 从最低位的存活节点出发整字扩展到不动点，剥掉该分量后继续
+   */
+  static constexpr int num_components(uint64_t nodes, uint64_t h_links,
+                                      uint64_t v_links) {
+    int count = 0;
+    uint64_t remaining = nodes & kNodeMask;
+    while (remaining != 0) {
+      uint64_t component = remaining & (~remaining + 1);
+      uint64_t previous = 0;
+      while (component != previous) {
+        previous = component;
+        component = expand(component, h_links, v_links);
+      }
+      remaining &= ~component;
+      ++count;
+    }
+    return count;
+  }
+
+  // 分数：边数 * 1 + 节点数 * 3（节点数按顶点总数计算）
+  static constexpr int score(uint64_t h_links, uint64_t v_links) {
+    return std::popcount(h_links) + std::popcount(v_links) + kNumVertices * 3;
+  }
+
+  static constexpr bool is_full(uint64_t h_links, uint64_t v_links) {
+    return std::popcount(h_links) + std::popcount(v_links) == kNumEdges;
+  }
+
+  static constexpr bool is_all_nodes_exist(uint64_t nodes) {
+    return (nodes & kNodeMask) == kNodeMask;
+  }
+};
+
+static_assert(FixedMesh<4>::num_components(FixedMesh<4>::kNodeMask,
+                                           FixedMesh<4>::kHLinkMask,
+                                           FixedMesh<4>::kVLinkMask) == 1);
+static_assert(FixedMesh<8>::kNeighbors[0] == 0b1'0000'0010);
+
+/**
+ * @brief 按运行时网格大小分派到编译期特化
+ * @param N 网格大小
+ * @param visit 以 FixedMesh<K>{} 为参数调用的函数
+ * @return N 在 2..8 范围内并完成调用时返回 true，否则返回 false
+ *
+ * 不在特化范围内的网格由调用方走通用路径
+ */
+template <typename Visitor> bool visit_fixed_mesh(int N, Visitor &&visit) {
+  return [&]<int... Ks>(std::integer_sequence<int, Ks...>) {
+    return ((N == Ks + kFixedMeshMinSize
+                 ? (visit(FixedMesh<Ks + kFixedMeshMinSize>{}), true)
+                 : false) ||
+            ...);
+  }(std::make_integer_sequence<int, kFixedMeshMaxSize - kFixedMeshMinSize +
+                                        1>{});
+}
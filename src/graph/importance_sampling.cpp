@@ -0,0 +1,221 @@
+/**
+ * @file importance_sampling.cpp
+ * @brief 稀有失效良率的重要性抽样估计实现
+ *
+ * 实现放大错误率下的加权抽样、放大倍数的自动选择以及方差估计
+ */
+
+#include "importance_sampling.h"
+#include "error_inject.h"
+#include "fault_sampler.h"
+#include "mesh_batch.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief 加权样本的累加量
+ */
+struct WeightedSums {
+  int num_samples = 0;
+  double sum_weight = 0.0;
+  double sum_weight_sq = 0.0;
+  double sum_sub_graphs = 0.0;
+  double sum_sub_graphs_sq = 0.0;
+  double sum_incomplete = 0.0;
+  double sum_incomplete_sq = 0.0;
+
+  WeightedSums &operator+=(const WeightedSums &other) {
+    num_samples += other.num_samples;
+    sum_weight += other.sum_weight;
+    sum_weight_sq += other.sum_weight_sq;
+    sum_sub_graphs += other.sum_sub_graphs;
+    sum_sub_graphs_sq += other.sum_sub_graphs_sq;
+    sum_incomplete += other.sum_incomplete;
+    sum_incomplete_sq += other.sum_incomplete_sq;
+    return *this;
+  }
+};
+
+// 由加权指示量的和与平方和得到均值及其方差
+WeightedEstimate make_estimate(int n, double sum, double sum_sq) {
+  WeightedEstimate estimate;
+  if (n == 0) {
+    return estimate;
+  }
+  estimate.probability = sum / n;
+  if (n > 1) {
+    double sample_variance =
+        std::max(0.0, (sum_sq - n * estimate.probability * estimate.probability) /
+                          (n - 1));
+    estimate.variance = sample_variance / n;
+  }
+  return estimate;
+}
+
+// 放大后的错误率，不超过 0.5；目标错误率为 0 时不放大
+float tilt(float rate, float factor) {
+  if (rate <= 0.0f || rate >= 0.5f) {
+    return rate;
+  }
+  return std::min(0.5f, rate * factor);
+}
+
+/**
+ * @brief 按给定的抽样错误率加权抽样
+ * @param config 配置（使用其中的网格大小、目标错误率和并行参数）
+ * @param tilted_node_rate 抽样节点错误率
+ * @param tilted_edge_rate 抽样边错误率
+ * @param num_samples 芯片数量
+ * @param cell_idx 随机流的格子索引，不同的试抽互不重叠
+ * @return 累加量
+ */
+WeightedSums run_tilted(const ImportanceSamplingConfig &config,
+                        float tilted_node_rate, float tilted_edge_rate,
+                        int num_samples, int cell_idx) {
+  const int N = config.mesh_size;
+  const int V = N * N;
+  const int E = 2 * N * (N - 1);
+  const int chunk = std::max(MeshBatch::kLanes, config.chunk_size);
+  const int num_chunks = (num_samples + chunk - 1) / chunk;
+
+  std::vector<WeightedSums> sums(num_chunks);
+  tbb::enumerable_thread_specific<MeshBatch> scratch;
+
+  auto run_chunk = [&](int b) {
+    int first = b * chunk;
+    int chips = std::min(chunk, num_samples - first);
+
+    MeshBatch &batch = scratch.local();
+    if (batch.size() != N || batch.num_chips() != chips) {
+      batch = MeshBatch(N, chips);
+    } else {
+      batch.reset();
+    }
+
+    std::vector<double> weights(chips);
+    for (int c = 0; c < chips; ++c) {
+      Philox4x32 rng = chip_fault_rng(config.seed, N, cell_idx, first + c);
+      int64_t dead_edges = 0;
+      int64_t dead_nodes = 0;
+      sample_bernoulli(E, tilted_edge_rate, rng, [&](int64_t e) {
+        batch.delete_edge_by_id(c, static_cast<int>(e));
+        ++dead_edges;
+      });
+      sample_bernoulli(V, tilted_node_rate, rng, [&](int64_t v) {
+        batch.delete_node(c, static_cast<int>(v));
+        ++dead_nodes;
+      });
+      weights[c] = std::exp(
+          bernoulli_log_likelihood_ratio(E, dead_edges, config.edge_error_rate,
+                                         tilted_edge_rate) +
+          bernoulli_log_likelihood_ratio(V, dead_nodes, config.node_error_rate,
+                                         tilted_node_rate));
+    }
+
+    std::vector<char> sub_graphs = batch.has_subgraphs();
+    std::vector<char> full = batch.is_full();
+    WeightedSums &out = sums[b];
+    out.num_samples = chips;
+    for (int c = 0; c < chips; ++c) {
+      double w = weights[c];
+      out.sum_weight += w;
+      out.sum_weight_sq += w * w;
+      if (sub_graphs[c]) {
+        out.sum_sub_graphs += w;
+        out.sum_sub_graphs_sq += w * w;
+      }
+      if (!full[c]) {
+        out.sum_incomplete += w;
+        out.sum_incomplete_sq += w * w;
+      }
+    }
+  };
+
+  tbb::task_arena arena(config.num_threads > 0 ? config.num_threads
+                                               : tbb::task_arena::automatic);
+  arena.execute([&] {
+    tbb::parallel_for(tbb::blocked_range<int>(0, num_chunks, 1),
+                      [&](const tbb::blocked_range<int> &range) {
+                        for (int b = range.begin(); b != range.end(); ++b) {
+                          run_chunk(b);
+                        }
+                      });
+  });
+
+  WeightedSums total;
+  for (const auto &s : sums) {
+    total += s;
+  }
+  return total;
+}
+
+} // namespace
+
+double WeightedEstimate::std_error() const { return std::sqrt(variance); }
+
+double WeightedEstimate::relative_error() const {
+  return probability > 0.0 ? std_error() / probability
+                           : std::numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief 重要性抽样估计良率
+ * @param config 配置
+ * @return 估计结果
+ *
+ * 自动模式下依次试抽放大倍数 1, 2, 4, ..., 32，
+ * 选择有子图概率相对误差最小的倍数；试抽全部没有命中时取最大的倍数
+ */
+ImportanceSamplingResult
+importance_sample_yield(const ImportanceSamplingConfig &config) {
+  float factor = config.tilt_factor;
+  if (factor <= 0.0f) {
+    constexpr float kCandidates[] = {1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 32.0f};
+    double best = std::numeric_limits<double>::infinity();
+    factor = kCandidates[std::size(kCandidates) - 1];
+    for (size_t i = 0; i < std::size(kCandidates); ++i) {
+      WeightedSums pilot = run_tilted(
+          config, tilt(config.node_error_rate, kCandidates[i]),
+          tilt(config.edge_error_rate, kCandidates[i]), config.pilot_samples,
+          static_cast<int>(i) + 1);
+      WeightedEstimate estimate = make_estimate(
+          pilot.num_samples, pilot.sum_sub_graphs, pilot.sum_sub_graphs_sq);
+      double relative_error = estimate.relative_error();
+      if (relative_error < best) {
+        best = relative_error;
+        factor = kCandidates[i];
+      }
+    }
+  }
+
+  ImportanceSamplingResult result;
+  result.mesh_size = config.mesh_size;
+  result.node_error_rate = config.node_error_rate;
+  result.edge_error_rate = config.edge_error_rate;
+  result.tilted_node_error_rate = tilt(config.node_error_rate, factor);
+  result.tilted_edge_error_rate = tilt(config.edge_error_rate, factor);
+
+  WeightedSums sums =
+      run_tilted(config, result.tilted_node_error_rate,
+                 result.tilted_edge_error_rate, std::max(0, config.num_samples),
+                 0);
+  result.num_samples = sums.num_samples;
+  result.effective_sample_size =
+      sums.sum_weight_sq > 0.0
+          ? sums.sum_weight * sums.sum_weight / sums.sum_weight_sq
+          : 0.0;
+  result.sub_graphs = make_estimate(sums.num_samples, sums.sum_sub_graphs,
+                                    sums.sum_sub_graphs_sq);
+  result.incomplete = make_estimate(sums.num_samples, sums.sum_incomplete,
+                                    sums.sum_incomplete_sq);
+  return result;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file importance_sampling.h
+ * @brief 稀有失效良率的重要性抽样估计声明
+ *
+ * 低错误率下有子图的芯片极少，直接抽样几乎抽不到。
+ * 改为按放大后的错误率注入故障，再按似然比给每个芯片加权，得到无偏估计
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief 重要性抽样配置
+ *
+ * tilt_factor 为 0 时，先用少量芯片试抽几个候选放大倍数，
+ * 选择相对误差最小的一个
+ */
+struct ImportanceSamplingConfig {
+  int mesh_size = 4;            // 网格大小 k（k x k）
+  float node_error_rate = 0.0f; // 目标节点错误率（0.0-1.0）
+  float edge_error_rate = 0.0f; // 目标边错误率（0.0-1.0）
+  float tilt_factor = 0.0f;     // 抽样错误率 = 目标错误率 x 放大倍数，0 表示自动
+  int num_samples = 10000;      // 芯片数量
+  int pilot_samples = 2048;     // 自动选择放大倍数时每个候选的试抽芯片数量
+  int chunk_size = 1024;        // 每个任务的芯片数量
+  uint64_t seed = 42;           // 随机种子
+  int num_threads = 0;          // 工作线程数，0 表示使用全部核心
+};
+
+/**
+ * @brief 单个概率的加权估计
+ */
+struct WeightedEstimate {
+  double probability = 0.0; // 无偏估计
+  double variance = 0.0;    // 估计值的方差
+
+  double std_error() const;
+  double relative_error() const; // 标准误差 / 估计值，估计值为 0 时为无穷大
+};
+
+/**
+ * @brief 重要性抽样结果
+ */
+struct ImportanceSamplingResult {
+  int mesh_size = 0;
+  float node_error_rate = 0.0f;
+  float edge_error_rate = 0.0f;
+  float tilted_node_error_rate = 0.0f; // 实际抽样使用的节点错误率
+  float tilted_edge_error_rate = 0.0f; // 实际抽样使用的边错误率
+  int num_samples = 0;
+  double effective_sample_size = 0.0; // (sum w)^2 / sum w^2
+
+  WeightedEstimate sub_graphs;  // P(has_subgraphs)
+  WeightedEstimate incomplete;  // P(!is_full)
+};
+
+/**
+ * @brief 重要性抽样估计良率
+ * @param config 配置
+ * @return 有子图和不完整芯片的概率估计及其方差
+ *
+ * 每个芯片按放大后的错误率做独立伯努利注入（chip_fault_rng 随机流），
+ * 权重为目标分布与抽样分布下该故障数量的似然比
+ */
+ImportanceSamplingResult
+importance_sample_yield(const ImportanceSamplingConfig &config);
@@ -9,9 +9,11 @@
 #include "common.h"
 #include <algorithm>
 #include <format>
+#include <mutex>
 #include <numeric>
 #include <ranges>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -66,7 +68,25 @@ GraphWithMetadata generate_mesh_graph_manual(const int N) {
                                 bottom_node_idx); // 顺延边的序号
     }
   });
-  return GraphWithMetadata(g);
+  return GraphWithMetadata(g, mesh_layout(N));
+}
+
+/**
+ * @brief 获取指定大小的网格原型
+ * @param N 网格大小（N x N）
+ * @return 共享的只读原型
+ */
+std::shared_ptr<const MeshPrototype> mesh_prototype(const int N) {
+  static std::mutex mutex;
+  static std::unordered_map<int, std::shared_ptr<const MeshPrototype>> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &prototype = cache[N];
+  if (!prototype) {
+    prototype = std::make_shared<const MeshPrototype>(
+        MeshPrototype{mesh_layout(N), generate_mesh_graph_manual(N).graph()});
+  }
+  return prototype;
 }
 
 /**
@@ -74,22 +94,29 @@ GraphWithMetadata generate_mesh_graph_manual(const int N) {
  * @param N 生成图的数量
  * @param batch_size 每个网格图的大小（batch_size x batch_size）
  * @return 生成的网格图向量
+ *
+ * 完整网格只构建一次，每个芯片只持有指向共享原型的指针和自己的故障位掩码，
+ * 不再为每个芯片重复格式化节点/边名称和加边
  */
 std::vector<GraphWithMetadata>
 generate_mesh_graph_manual_batch(const int N, const int batch_size) {
-  auto graph_indices = std::views::iota(0, N);
+  auto prototype = mesh_prototype(batch_size);
+  MeshBitset overlay(batch_size);
 
-  return graph_indices | std::views::transform([N, batch_size](int) {
-           return generate_mesh_graph_manual(batch_size);
+  return std::views::iota(0, N) |
+         std::views::transform([&prototype, &overlay](int) {
+           return GraphWithMetadata(overlay, prototype);
          }) |
          std::ranges::to<std::vector>();
+}
 
-  // std::vector<Graph> graphs(N);
-  // std::generate(graphs.begin(), graphs.end(),
-  //     [batch_size]() {
-  //         return generate_mesh_graph_manual(batch_size);
-  //     }
-  // );
-
-  // return graphs;
+/**
+ * @brief 生成使用位压缩后端的网格图
+ * @param N 网格大小（N x N）
+ * @return 以 MeshBitset 为后端、共享网格原型的网格图
+ *
+ * 不构造 Boost Graph，只在调用 graph() 时才从原型物化
+ */
+GraphWithMetadata generate_mesh_bitset(const int N) {
+  return GraphWithMetadata(MeshBitset(N), mesh_prototype(N));
 }
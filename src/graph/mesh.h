@@ -10,6 +10,24 @@
 #include "common.h"
 #include "mesh_data.h"
 
+/**
+ * @brief 共享的完整网格原型
+ *
+ * 同一尺寸的芯片共享一份完整网格，每个芯片只保存自己的故障叠加层
+ * （MeshBitset），需要 Boost Graph 时从原型复制后回放故障
+ */
+struct MeshPrototype {
+  std::shared_ptr<const MeshLayout> layout; // 边 ID 查找表
+  Graph graph;                              // 完整网格（所有节点和边都存在）
+};
+
+/**
+ * @brief 获取指定大小的网格原型
+ * @param N 网格大小（N x N）
+ * @return 共享的只读原型，同一大小只构建一次（线程安全）
+ */
+std::shared_ptr<const MeshPrototype> mesh_prototype(int N);
+
 /**
  * @brief 手动生成网格图
  * @param N 网格大小（N x N）
@@ -22,6 +40,15 @@ GraphWithMetadata generate_mesh_graph_manual(int N);
  * @param N 生成图的数量
  * @param batch_size 每个网格图的大小（batch_size x batch_size）
  * @return 生成的网格图向量
+ *
+ * 所有芯片共享同一个 mesh_prototype(batch_size)，芯片本身只是位压缩的故障叠加层
  */
 std::vector<GraphWithMetadata>
-generate_mesh_graph_manual_batch(const int N, const int batch_size);
\ No newline at end of file
+generate_mesh_graph_manual_batch(const int N, const int batch_size);
+
+/**
+ * @brief 生成使用位压缩后端的网格图
+ * @param N 网格大小（N x N）
+ * @return 以 MeshBitset 为后端、共享网格原型的网格图
+ */
+GraphWithMetadata generate_mesh_bitset(int N);
@@ -0,0 +1,323 @@
+/**
+ * @file mesh_batch.cpp
+ * @brief 位切片批量网格实现
+ *
+ * 实现批量网格的构造、转换、故障修改以及整批的连通性判断
+ */
+
+#include "mesh_batch.h"
+#include "mesh.h"
+
+/**
+ * @brief 生成完整的批量网格
+ * @param N 网格大小（N x N）
+ * @param num_chips 芯片数量
+ *
+ * 只有真实芯片对应的通道被置位，最后一个切片多出的通道保持为 0
+ */
+MeshBatch::MeshBatch(int N, int num_chips)
+    : n_(N), num_chips_(num_chips),
+      num_slices_((num_chips + kLanes - 1) / kLanes) {
+  size_t words = static_cast<size_t>(N) * N * num_slices_;
+  nodes_.assign(words, 0);
+  h_links_.assign(words, 0);
+  v_links_.assign(words, 0);
+  reset();
+}
+
+/**
+ * @brief 把所有芯片恢复为完整网格
+ *
+ * 复用已有的存储，不重新分配，适合作为扫描中反复使用的临时批量
+ */
+void MeshBatch::reset() {
+  const int N = n_;
+  for (int v = 0; v < N * N; ++v) {
+    for (int s = 0; s < num_slices_; ++s) {
+      uint64_t lanes = lane_mask(s);
+      nodes_[word_index(v, s)] = lanes;
+      h_links_[word_index(v, s)] = (v % N < N - 1) ? lanes : 0;
+      v_links_[word_index(v, s)] = (v / N < N - 1) ? lanes : 0;
+    }
+  }
+}
+
+// 切片中真实芯片对应的通道
+uint64_t MeshBatch::lane_mask(int slice) const {
+  int lanes = num_chips_ - slice * kLanes;
+  return lanes >= kLanes ? ~uint64_t{0} : (uint64_t{1} << lanes) - 1;
+}
+
+/**
+ * @brief 从图向量构造批量网格
+ * @param graphs 图向量（所有图的大小必须相同）
+ * @return 与各个图的故障状态一致的批量网格
+ */
+MeshBatch MeshBatch::from_graphs(const std::vector<GraphWithMetadata> &graphs) {
+  if (graphs.empty()) {
+    return MeshBatch();
+  }
+
+  const int N = static_cast<int>(graphs[0].graph_size());
+  MeshBatch batch(N, static_cast<int>(graphs.size()));
+  std::ranges::fill(batch.h_links_, 0);
+  std::ranges::fill(batch.v_links_, 0);
+
+  for (int c = 0; c < batch.num_chips_; ++c) {
+    const auto &g = graphs[c];
+    int slice = c / kLanes;
+    uint64_t bit = uint64_t{1} << (c % kLanes);
+
+    for (int v = 0; v < N * N; ++v) {
+      if (!g.node_alive(v)) {
+        batch.nodes_[batch.word_index(v, slice)] &= ~bit;
+      }
+    }
+    for (auto [source_idx, target_idx] : g.collect_valid_edges()) {
+      int low = std::min(source_idx, target_idx);
+      int high = std::max(source_idx, target_idx);
+      auto &links = (high == low + 1) ? batch.h_links_ : batch.v_links_;
+      links[batch.word_index(low, slice)] |= bit;
+    }
+  }
+  return batch;
+}
+
+/**
+ * @brief 取出单个芯片
+ * @param chip_idx 芯片索引
+ * @return 以 MeshBitset 为后端、共享网格原型的图
+ */
+GraphWithMetadata MeshBatch::chip(int chip_idx) const {
+  int slice = chip_idx / kLanes;
+  int lane = chip_idx % kLanes;
+  auto test = [&](const std::vector<uint64_t> &words, int v) {
+    return (words[word_index(v, slice)] >> lane) & 1;
+  };
+
+  MeshBitset bits(n_);
+  for (int v = 0; v < num_vertices(); ++v) {
+    if (!test(nodes_, v)) {
+      bits.delete_node(v);
+      continue;
+    }
+    if (v % n_ < n_ - 1 && !test(h_links_, v)) {
+      bits.delete_edge(v, v + 1);
+    }
+    if (v / n_ < n_ - 1 && !test(v_links_, v)) {
+      bits.delete_edge(v, v + n_);
+    }
+  }
+  return GraphWithMetadata(std::move(bits), mesh_prototype(n_));
+}
+
+bool MeshBatch::node_alive(int chip_idx, int node_idx) const {
+  if (node_idx < 0 || node_idx >= num_vertices()) {
+    return false;
+  }
+  return (nodes_[word_index(node_idx, chip_idx / kLanes)] >>
+          (chip_idx % kLanes)) &
+         1;
+}
+
+/**
+ * @brief 删除单个芯片的节点
+ * @param chip_idx 芯片索引
+ * @param node_idx 节点索引
+ *
+ * 同时清除该节点的四条相连链路
+ */
+void MeshBatch::delete_node(int chip_idx, int node_idx) {
+  if (!node_alive(chip_idx, node_idx)) {
+    return;
+  }
+  int slice = chip_idx / kLanes;
+  uint64_t keep = ~(uint64_t{1} << (chip_idx % kLanes));
+
+  nodes_[word_index(node_idx, slice)] &= keep;
+  h_links_[word_index(node_idx, slice)] &= keep;
+  v_links_[word_index(node_idx, slice)] &= keep;
+  if (node_idx % n_ > 0) {
+    h_links_[word_index(node_idx - 1, slice)] &= keep;
+  }
+  if (node_idx >= n_) {
+    v_links_[word_index(node_idx - n_, slice)] &= keep;
+  }
+}
+
+/**
+ * @brief 按边 ID 删除单个芯片的链路
+ * @param chip_idx 芯片索引
+ * @param edge_id 边 ID（编号规则见 MeshLayout）
+ * @return 边 ID 有效时返回 true
+ */
+bool MeshBatch::delete_edge_by_id(int chip_idx, int edge_id) {
+  if (edge_id < 0 || edge_id >= num_edges()) {
+    return false;
+  }
+  int slice = chip_idx / kLanes;
+  uint64_t keep = ~(uint64_t{1} << (chip_idx % kLanes));
+
+  int num_horizontal = n_ * (n_ - 1);
+  if (edge_id < num_horizontal) {
+    int row = edge_id / (n_ - 1);
+    int col = edge_id % (n_ - 1);
+    h_links_[word_index(row * n_ + col, slice)] &= keep;
+  } else {
+    v_links_[word_index(edge_id - num_horizontal, slice)] &= keep;
+  }
+  return true;
+}
+
+/**
+ * @brief 所有芯片同时删除孤立节点
+ *
+ * 节点保留的条件是四个方向至少有一条链路，对每个节点逐字计算
+ */
+void MeshBatch::delete_isolated_nodes() {
+  for (int v = 0; v < num_vertices(); ++v) {
+    bool has_left = v % n_ > 0;
+    bool has_top = v >= n_;
+    for (int s = 0; s < num_slices_; ++s) {
+      uint64_t linked = h_links_[word_index(v, s)] | v_links_[word_index(v, s)];
+      if (has_left) {
+        linked |= h_links_[word_index(v - 1, s)];
+      }
+      if (has_top) {
+        linked |= v_links_[word_index(v - n_, s)];
+      }
+      nodes_[word_index(v, s)] &= linked;
+    }
+  }
+}
+
+/**
+ * @brief 整批泛洪
+ * @return 每个芯片从其最低索引存活节点出发能到达的节点（按节点和切片存放）
+ *
+ * 先为每条通道挑出种子节点，再交替正向、反向扫描所有节点，
+ * 每个节点从四个方向的邻居吸收可达位，直到整批不再变化
+ */
+std::vector<uint64_t> MeshBatch::flood_fill() const {
+  const int V = num_vertices();
+  std::vector<uint64_t> reach(nodes_.size(), 0);
+  std::vector<uint64_t> unseeded(num_slices_, ~uint64_t{0});
+
+  for (int v = 0; v < V; ++v) {
+    for (int s = 0; s < num_slices_; ++s) {
+      reach[word_index(v, s)] = nodes_[word_index(v, s)] & unseeded[s];
+      unseeded[s] &= ~nodes_[word_index(v, s)];
+    }
+  }
+
+  auto relax = [&](int v) {
+    int col = v % n_;
+    uint64_t changed = 0;
+    for (int s = 0; s < num_slices_; ++s) {
+      uint64_t r = reach[word_index(v, s)];
+      uint64_t before = r;
+      if (col > 0) {
+        r |= reach[word_index(v - 1, s)] & h_links_[word_index(v - 1, s)];
+      }
+      if (col < n_ - 1) {
+        r |= reach[word_index(v + 1, s)] & h_links_[word_index(v, s)];
+      }
+      if (v >= n_) {
+        r |= reach[word_index(v - n_, s)] & v_links_[word_index(v - n_, s)];
+      }
+      if (v + n_ < V) {
+        r |= reach[word_index(v + n_, s)] & v_links_[word_index(v, s)];
+      }
+      reach[word_index(v, s)] = r;
+      changed |= r ^ before;
+    }
+    return changed;
+  };
+
+  bool forward = true;
+  uint64_t changed = ~uint64_t{0};
+  while (changed != 0) {
+    changed = 0;
+    for (int i = 0; i < V; ++i) {
+      changed |= relax(forward ? i : V - 1 - i);
+    }
+    forward = !forward;
+  }
+  return reach;
+}
+
+// 把每个切片的通道掩码展开为逐芯片结果
+std::vector<char>
+MeshBatch::unpack_lanes(const std::vector<uint64_t> &lanes) const {
+  std::vector<char> result(num_chips_);
+  for (int c = 0; c < num_chips_; ++c) {
+    result[c] = (lanes[c / kLanes] >> (c % kLanes)) & 1;
+  }
+  return result;
+}
+
+/**
+ * @brief 所有芯片是否有子图
+ * @return 第 c 项为第 c 个芯片的 has_subgraphs()
+ *
+ * 泛洪之后仍有未到达的存活节点，说明连通分量数量大于 1
+ */
+std::vector<char> MeshBatch::has_subgraphs() const {
+  std::vector<uint64_t> reach = flood_fill();
+  std::vector<uint64_t> unreached(num_slices_, 0);
+  for (int v = 0; v < num_vertices(); ++v) {
+    for (int s = 0; s < num_slices_; ++s) {
+      unreached[s] |= nodes_[word_index(v, s)] & ~reach[word_index(v, s)];
+    }
+  }
+  return unpack_lanes(unreached);
+}
+
+/**
+ * @brief 所有芯片是否恰好一个连通分量
+ * @return 第 c 项为第 c 个芯片的 num_components() == 1
+ *
+ * 至少有一个存活节点，并且泛洪到达了所有存活节点
+ */
+std::vector<char> MeshBatch::is_connected() const {
+  std::vector<uint64_t> reach = flood_fill();
+  std::vector<uint64_t> any_alive(num_slices_, 0);
+  std::vector<uint64_t> unreached(num_slices_, 0);
+  for (int v = 0; v < num_vertices(); ++v) {
+    for (int s = 0; s < num_slices_; ++s) {
+      any_alive[s] |= nodes_[word_index(v, s)];
+      unreached[s] |= nodes_[word_index(v, s)] & ~reach[word_index(v, s)];
+    }
+  }
+  for (int s = 0; s < num_slices_; ++s) {
+    any_alive[s] &= ~unreached[s];
+  }
+  return unpack_lanes(any_alive);
+}
+
+// 所有芯片是否所有节点都存在
+std::vector<char> MeshBatch::is_all_nodes_exist() const {
+  std::vector<uint64_t> all_alive(num_slices_, ~uint64_t{0});
+  for (int v = 0; v < num_vertices(); ++v) {
+    for (int s = 0; s < num_slices_; ++s) {
+      all_alive[s] &= nodes_[word_index(v, s)];
+    }
+  }
+  return unpack_lanes(all_alive);
+}
+
+// 所有芯片是否完整：完整网格中的每条链路都存在
+std::vector<char> MeshBatch::is_full() const {
+  std::vector<uint64_t> all_links(num_slices_, ~uint64_t{0});
+  for (int v = 0; v < num_vertices(); ++v) {
+    for (int s = 0; s < num_slices_; ++s) {
+      if (v % n_ < n_ - 1) {
+        all_links[s] &= h_links_[word_index(v, s)];
+      }
+      if (v / n_ < n_ - 1) {
+        all_links[s] &= v_links_[word_index(v, s)];
+      }
+    }
+  }
+  return unpack_lanes(all_links);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file mesh_batch.h
+ * @brief 位切片批量网格定义
+ *
+ * 把 64 个芯片的同一个节点/链路位放进同一个 uint64_t，
+ * 故障注入、孤立节点删除和连通性判断对整批芯片同时进行
+ */
+
+#pragma once
+
+#include "mesh_data.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 位切片批量网格
+ *
+ * 芯片按 64 个一组分成若干切片（slice），第 c 个芯片位于切片 c / 64 的
+ * 第 c % 64 条通道（lane）。三组字都按 v * num_slices + slice 存放：
+ * - nodes_   节点 v 存活的通道
+ * - h_links_ 横向链路 v -- v+1 存在的通道
+ * - v_links_ 纵向链路 v -- v+N 存在的通道
+ *
+ * 同一节点的各切片在内存中相邻，逐节点的内层循环可以被编译器向量化，
+ * 相当于一次处理 4 个切片（256 个芯片）
+ */
+class MeshBatch {
+private:
+  int n_ = 0;
+  int num_chips_ = 0;
+  int num_slices_ = 0;
+  std::vector<uint64_t> nodes_;
+  std::vector<uint64_t> h_links_;
+  std::vector<uint64_t> v_links_;
+
+  size_t word_index(int node_idx, int slice) const {
+    return static_cast<size_t>(node_idx) * num_slices_ + slice;
+  }
+
+  // 切片中真实芯片对应的通道（最后一个切片可能不满）
+  uint64_t lane_mask(int slice) const;
+
+  // 私有方法：每个切片中从各自最低存活节点出发的可达集合
+  std::vector<uint64_t> flood_fill() const;
+
+  // 私有方法：把每个切片的通道掩码展开为逐芯片结果
+  std::vector<char> unpack_lanes(const std::vector<uint64_t> &lanes) const;
+
+public:
+  static constexpr int kLanes = 64; // 每个字的芯片数
+
+  MeshBatch() = default;
+
+  // 生成 num_chips 个完整的 N x N 网格
+  MeshBatch(int N, int num_chips);
+
+  // 把所有芯片恢复为完整网格（复用存储）
+  void reset();
+
+  // 与 GraphWithMetadata 相互转换（所有图的大小必须相同）
+  static MeshBatch from_graphs(const std::vector<GraphWithMetadata> &graphs);
+  GraphWithMetadata chip(int chip_idx) const;
+
+  // 网格大小与计数
+  int size() const { return n_; }
+  int num_vertices() const { return n_ * n_; }
+  int num_edges() const { return 2 * n_ * (n_ - 1); } // 每个芯片的链路总数
+  int num_chips() const { return num_chips_; }
+
+  // 单个芯片的查询
+  bool node_alive(int chip_idx, int node_idx) const;
+
+  // 单个芯片的修改接口，编号与 GraphWithMetadata 一致
+  void delete_node(int chip_idx, int node_idx);
+  bool delete_edge_by_id(int chip_idx, int edge_id);
+
+  // 所有芯片同时删除度数为 0 的存活节点
+  void delete_isolated_nodes();
+
+  // 所有芯片的元数据，第 c 项对应第 c 个芯片，语义与 GraphWithMetadata 一致
+  std::vector<char> has_subgraphs() const;      // num_components() > 1
+  std::vector<char> is_connected() const;       // num_components() == 1
+  std::vector<char> is_all_nodes_exist() const; // 所有节点都存在
+  std::vector<char> is_full() const;            // 所有链路都存在
+};
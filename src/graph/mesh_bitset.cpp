@@ -0,0 +1,358 @@
+/**
+ * @file mesh_bitset.cpp
+ * @brief 位压缩网格图实现
+ *
+ * 实现位压缩网格图的构造、转换、删除操作和元数据计算
+ */
+
+#include "mesh_bitset.h"
+#include "fixed_mesh.h"
+#include <bit>
+#include <format>
+#include <string>
+
+/**
+ * @brief 生成完整的网格
+ * @param N 网格大小（N x N）
+ *
+ * 所有节点存活，所有横向链路（列号 < N-1）和纵向链路（行号 < N-1）都存在
+ */
+MeshBitset::MeshBitset(int N) : n_(N) {
+  size_t words = (static_cast<size_t>(N) * N + 63) / 64;
+  nodes_.assign(words, 0);
+  h_links_.assign(words, 0);
+  v_links_.assign(words, 0);
+
+  for (int v = 0; v < N * N; ++v) {
+    set_bit(nodes_, v);
+    if (v % N < N - 1) {
+      set_bit(h_links_, v);
+    }
+    if (v / N < N - 1) {
+      set_bit(v_links_, v);
+    }
+  }
+}
+
+/**
+ * @brief 从 Graph 构造位压缩表示
+ * @param g 网格图（顶点数必须是完全平方数）
+ * @return 对应的位压缩网格
+ */
+MeshBitset MeshBitset::from_graph(const Graph &g) {
+  int num_vertices = static_cast<int>(boost::num_vertices(g));
+  int N = static_cast<int>(std::sqrt(num_vertices));
+
+  MeshBitset mesh;
+  mesh.n_ = N;
+  size_t words = (static_cast<size_t>(num_vertices) + 63) / 64;
+  mesh.nodes_.assign(words, 0);
+  mesh.h_links_.assign(words, 0);
+  mesh.v_links_.assign(words, 0);
+
+  for (int v = 0; v < num_vertices; ++v) {
+    if (!g[boost::vertex(v, g)].is_deleted) {
+      set_bit(mesh.nodes_, v);
+    }
+  }
+
+  auto [edge_begin, edge_end] = boost::edges(g);
+  for (auto it = edge_begin; it != edge_end; ++it) {
+    int source_idx = static_cast<int>(boost::source(*it, g));
+    int target_idx = static_cast<int>(boost::target(*it, g));
+    int low = std::min(source_idx, target_idx);
+    int high = std::max(source_idx, target_idx);
+
+    if (high == low + 1) {
+      set_bit(mesh.h_links_, low);
+    } else if (high == low + N) {
+      set_bit(mesh.v_links_, low);
+    }
+  }
+  return mesh;
+}
+
+/**
+ * @brief 转换为 Boost Graph
+ * @return 与 generate_mesh_graph_manual 结构一致的图
+ *
+ * 节点名称、边名称和边 ID 与手动生成的网格相同，
+ * 已删除的节点保留索引并标记 is_deleted
+ */
+Graph MeshBitset::to_graph() const {
+  const int N = n_;
+  Graph g(N * N);
+
+  for (int idx = 0; idx < N * N; ++idx) {
+    g[idx] = Node(idx, std::format("node_({},{})", idx / N, idx % N));
+    g[idx].is_deleted = !test_bit(nodes_, idx);
+  }
+
+  // 横向边，ID 为 row * (N - 1) + col
+  for (int idx = 0; idx < N * (N - 1); ++idx) {
+    int row = idx / (N - 1);
+    int col = idx % (N - 1);
+    int left_node_idx = row * N + col;
+    if (!test_bit(h_links_, left_node_idx)) {
+      continue;
+    }
+    auto edge_pair = boost::add_edge(left_node_idx, left_node_idx + 1, g);
+    g[edge_pair.first] =
+        Edge(idx, std::format("connect_horizontal_({},{})", row, col),
+             left_node_idx, left_node_idx + 1);
+  }
+
+  // 纵向边，ID 顺延在横向边之后
+  for (int idx = 0; idx < (N - 1) * N; ++idx) {
+    int row = idx / N;
+    int col = idx % N;
+    int top_node_idx = row * N + col;
+    if (!test_bit(v_links_, top_node_idx)) {
+      continue;
+    }
+    auto edge_pair = boost::add_edge(top_node_idx, top_node_idx + N, g);
+    g[edge_pair.first] =
+        Edge(idx + N * (N - 1), std::format("connect_vertical_({},{})", row, col),
+             top_node_idx, top_node_idx + N);
+  }
+  return g;
+}
+
+int MeshBitset::num_edges() const {
+  int count = 0;
+  for (size_t w = 0; w < h_links_.size(); ++w) {
+    count += std::popcount(h_links_[w]) + std::popcount(v_links_[w]);
+  }
+  return count;
+}
+
+int MeshBitset::num_alive_nodes() const {
+  int count = 0;
+  for (uint64_t word : nodes_) {
+    count += std::popcount(word);
+  }
+  return count;
+}
+
+bool MeshBitset::node_alive(int node_idx) const {
+  return node_idx >= 0 && node_idx < num_vertices() &&
+         test_bit(nodes_, node_idx);
+}
+
+/**
+ * @brief 检查链路是否存在
+ * @param source_idx 源节点索引
+ * @param target_idx 目标节点索引
+ * @return 两个节点相邻且链路存在时返回 true
+ */
+bool MeshBitset::has_edge(int source_idx, int target_idx) const {
+  if (!node_alive(source_idx) || !node_alive(target_idx)) {
+    return false;
+  }
+  int low = std::min(source_idx, target_idx);
+  int high = std::max(source_idx, target_idx);
+  if (high == low + 1 && low % n_ < n_ - 1) {
+    return test_bit(h_links_, low);
+  }
+  if (high == low + n_) {
+    return test_bit(v_links_, low);
+  }
+  return false;
+}
+
+int MeshBitset::degree(int node_idx) const {
+  if (!node_alive(node_idx)) {
+    return 0;
+  }
+  int col = node_idx % n_;
+  int degree = 0;
+  degree += test_bit(h_links_, node_idx);
+  degree += test_bit(v_links_, node_idx);
+  degree += col > 0 && test_bit(h_links_, node_idx - 1);
+  degree += node_idx >= n_ && test_bit(v_links_, node_idx - n_);
+  return degree;
+}
+
+std::vector<std::pair<int, int>> MeshBitset::edges() const {
+  std::vector<std::pair<int, int>> result;
+  result.reserve(num_edges());
+  for (int v = 0; v < num_vertices(); ++v) {
+    if (test_bit(h_links_, v)) {
+      result.emplace_back(v, v + 1);
+    }
+  }
+  for (int v = 0; v < num_vertices(); ++v) {
+    if (test_bit(v_links_, v)) {
+      result.emplace_back(v, v + n_);
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief 删除节点
+ * @param node_idx 节点索引
+ * @return 节点原本存活并被删除时返回 true
+ *
+ * 同时清除该节点的四条相连链路
+ */
+bool MeshBitset::delete_node(int node_idx) {
+  if (!node_alive(node_idx)) {
+    return false;
+  }
+  reset_bit(nodes_, node_idx);
+  reset_bit(h_links_, node_idx);
+  reset_bit(v_links_, node_idx);
+  if (node_idx % n_ > 0) {
+    reset_bit(h_links_, node_idx - 1);
+  }
+  if (node_idx >= n_) {
+    reset_bit(v_links_, node_idx - n_);
+  }
+  return true;
+}
+
+/**
+ * @brief 删除链路
+ * @param source_idx 源节点索引
+ * @param target_idx 目标节点索引
+ * @return 链路原本存在并被删除时返回 true
+ */
+bool MeshBitset::delete_edge(int source_idx, int target_idx) {
+  if (!has_edge(source_idx, target_idx)) {
+    return false;
+  }
+  int low = std::min(source_idx, target_idx);
+  if (std::max(source_idx, target_idx) == low + 1) {
+    reset_bit(h_links_, low);
+  } else {
+    reset_bit(v_links_, low);
+  }
+  return true;
+}
+
+/**
+ * @brief 恢复节点
+ * @param node_idx 节点索引
+ * @return 节点原本已删除并被恢复时返回 true
+ */
+bool MeshBitset::restore_node(int node_idx) {
+  if (node_idx < 0 || node_idx >= num_vertices() || node_alive(node_idx)) {
+    return false;
+  }
+  set_bit(nodes_, node_idx);
+  return true;
+}
+
+/**
+ * @brief 恢复链路
+ * @param source_idx 源节点索引
+ * @param target_idx 目标节点索引
+ * @return 链路原本不存在并被恢复时返回 true，两端不相邻或有节点已删除时返回 false
+ */
+bool MeshBitset::restore_edge(int source_idx, int target_idx) {
+  if (!node_alive(source_idx) || !node_alive(target_idx) ||
+      has_edge(source_idx, target_idx)) {
+    return false;
+  }
+  int low = std::min(source_idx, target_idx);
+  int high = std::max(source_idx, target_idx);
+  if (high == low + 1 && low % n_ < n_ - 1) {
+    set_bit(h_links_, low);
+  } else if (high == low + n_) {
+    set_bit(v_links_, low);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// 删除所有度数为 0 的存活节点，小网格走 FixedMesh 的单字位运算
+bool MeshBitset::delete_isolated_nodes() {
+  uint64_t isolated = 0;
+  if (visit_fixed_mesh(n_, [&](auto mesh) {
+        isolated = mesh.isolated_nodes(nodes_[0], h_links_[0], v_links_[0]);
+      })) {
+    nodes_[0] &= ~isolated;
+    return isolated != 0;
+  }
+
+  bool modified = false;
+  for (int v = 0; v < num_vertices(); ++v) {
+    if (test_bit(nodes_, v) && degree(v) == 0) {
+      reset_bit(nodes_, v);
+      modified = true;
+    }
+  }
+  return modified;
+}
+
+/**
+ * @brief 计算分数
+ * @return 边数 * 1 + 节点数 * 3
+ *
+ * 与 count_mesh_score 一致，节点数按顶点总数（含已删除节点）计算
+ */
+int MeshBitset::score() const { return num_edges() * 1 + num_vertices() * 3; }
+
+bool MeshBitset::is_full() const { return num_edges() == 2 * n_ * (n_ - 1); }
+
+bool MeshBitset::is_all_nodes_exist() const {
+  return num_alive_nodes() == num_vertices();
+}
+
+/**
+ * @brief 计算存活节点的连通分量数量
+ * @return 连通分量数量，没有存活节点时返回 0
+ *
+ * 直接在位掩码上做深度优先遍历，链路只会连接存活节点；
+ * 2..8 的小网格分派到 FixedMesh 的整字扩展
+ */
+int MeshBitset::num_components() const {
+  int fixed_count = 0;
+  if (visit_fixed_mesh(n_, [&](auto mesh) {
+        fixed_count =
+            mesh.num_components(nodes_[0], h_links_[0], v_links_[0]);
+      })) {
+    return fixed_count;
+  }
+
+  std::vector<uint64_t> visited(nodes_.size(), 0);
+  std::vector<int> stack;
+  stack.reserve(num_vertices());
+
+  int count = 0;
+  for (int v = 0; v < num_vertices(); ++v) {
+    if (!test_bit(nodes_, v) || test_bit(visited, v)) {
+      continue;
+    }
+    ++count;
+    set_bit(visited, v);
+    stack.push_back(v);
+
+    while (!stack.empty()) {
+      int u = stack.back();
+      stack.pop_back();
+
+      auto visit = [&](int w) {
+        if (!test_bit(visited, w)) {
+          set_bit(visited, w);
+          stack.push_back(w);
+        }
+      };
+      if (test_bit(h_links_, u)) {
+        visit(u + 1);
+      }
+      if (u % n_ > 0 && test_bit(h_links_, u - 1)) {
+        visit(u - 1);
+      }
+      if (test_bit(v_links_, u)) {
+        visit(u + n_);
+      }
+      if (u >= n_ && test_bit(v_links_, u - n_)) {
+        visit(u - n_);
+      }
+    }
+  }
+  return count;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file mesh_bitset.h
+ * @brief 位压缩网格图定义
+ *
+ * 用三组位掩码（存活节点、横向链路、纵向链路）表示 N x N 网格的故障状态，
+ * 作为 Boost Graph 之外的轻量后端
+ */
+
+#pragma once
+
+#include "common.h"
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 位压缩网格图
+ *
+ * 三组掩码都按节点索引 v = row * N + col 编址：
+ * - nodes_   第 v 位：节点 v 存活
+ * - h_links_ 第 v 位：横向链路 v -- v+1 存在
+ * - v_links_ 第 v 位：纵向链路 v -- v+N 存在
+ *
+ * 删除节点时同时清除其相连链路，与 Graph 上 clear_vertex 的语义一致
+ */
+class MeshBitset {
+private:
+  int n_ = 0;
+  std::vector<uint64_t> nodes_;
+  std::vector<uint64_t> h_links_;
+  std::vector<uint64_t> v_links_;
+
+  static bool test_bit(const std::vector<uint64_t> &bits, int i) {
+    return (bits[i >> 6] >> (i & 63)) & 1;
+  }
+  static void set_bit(std::vector<uint64_t> &bits, int i) {
+    bits[i >> 6] |= uint64_t{1} << (i & 63);
+  }
+  static void reset_bit(std::vector<uint64_t> &bits, int i) {
+    bits[i >> 6] &= ~(uint64_t{1} << (i & 63));
+  }
+
+public:
+  MeshBitset() = default;
+
+  // 生成完整的 N x N 网格（所有节点和链路都存在）
+  explicit MeshBitset(int N);
+
+  // 与 Graph 相互转换
+  static MeshBitset from_graph(const Graph &g);
+  Graph to_graph() const;
+
+  // 网格大小与计数
+  int size() const { return n_; }
+  int num_vertices() const { return n_ * n_; }
+  int num_edges() const;
+  int num_alive_nodes() const;
+
+  // 查询
+  bool node_alive(int node_idx) const;
+  bool has_edge(int source_idx, int target_idx) const;
+  int degree(int node_idx) const;
+
+  // 当前存在的链路，顺序与 generate_mesh_graph_manual 的加边顺序一致
+  std::vector<std::pair<int, int>> edges() const;
+
+  // 修改接口，返回是否真的改变了状态
+  bool delete_node(int node_idx);
+  bool delete_edge(int source_idx, int target_idx);
+  bool delete_isolated_nodes();
+
+  // 恢复接口（删除的逆操作），返回是否真的改变了状态。
+  // 恢复节点不会恢复其相连链路；两端节点都存活时才能恢复链路
+  bool restore_node(int node_idx);
+  bool restore_edge(int source_idx, int target_idx);
+
+  /**
+   * @brief 按升序遍历故障
+   * @param visit 对每个故障调用一次：已删除节点 v 给出 v，
+   *              不存在的链路给出 V + 边 ID（与 MeshLayout 一致）
+   *
+   * 直接扫描掩码的补集，时间与字数和故障数有关，适合稀疏故障
+   */
+  template <typename Visit> void for_each_fault(Visit &&visit) const {
+    const int V = num_vertices();
+    auto scan = [&](const std::vector<uint64_t> &bits, auto &&valid,
+                    auto &&emit) {
+      for (size_t w = 0; w < bits.size(); ++w) {
+        uint64_t missing = ~bits[w];
+        if (w == bits.size() - 1 && V % 64 != 0) {
+          missing &= (uint64_t{1} << (V % 64)) - 1;
+        }
+        while (missing != 0) {
+          int v = static_cast<int>(w * 64) + std::countr_zero(missing);
+          missing &= missing - 1;
+          if (valid(v)) {
+            emit(v);
+          }
+        }
+      }
+    };
+    auto always = [](int) { return true; };
+    scan(nodes_, always, [&](int v) { visit(v); });
+    // 横向边 ID 为 row * (N - 1) + col，纵向边 ID 为 N * (N - 1) + v
+    scan(h_links_, [&](int v) { return v % n_ < n_ - 1; },
+         [&](int v) { visit(V + v / n_ * (n_ - 1) + v % n_); });
+    scan(v_links_, [&](int v) { return v < V - n_; },
+         [&](int v) { visit(V + n_ * (n_ - 1) + v); });
+  }
+
+  // 元数据，语义与 GraphWithMetadata 对应接口一致
+  int score() const;
+  bool is_full() const;
+  bool is_all_nodes_exist() const;
+  int num_components() const;
+};
@@ -7,7 +7,12 @@
 
 #include "mesh_data.h"
 #include "error_inject.h"
+#include "fixed_mesh.h"
+#include "mesh.h"
 #include "mesh_utils.h"
+#include "metadata_cache.h"
+#include <charconv>
+#include <limits>
 
 /**
  * @brief 清除所有缓存
@@ -23,173 +28,194 @@ void GraphWithMetadata::invalidate_metadata() const {
   metadata_.is_all_nodes_exist.reset();
 }
 
-// 检查并清除脏标记（当所有属性都已计算时）
-void GraphWithMetadata::check_and_clear_dirty() const {
-  if (metadata_dirty_ && metadata_.has_subgraphs.has_value() &&
-      metadata_.is_full.has_value() && metadata_.num_components.has_value() &&
-      metadata_.score.has_value()) {
-    metadata_dirty_ = false;
-  }
-}
-
 /**
- * @brief 惰性计算：是否有子图
+ * @brief 物化位压缩后端
  *
- * 通过计算连通分量数量来判断是否存在子图（连通分量数量大于1）
+ * 使用位压缩后端且 graph_ 已过期时，按位掩码的当前状态重建 graph_。
+ * 有共享原型时复制原型并只回放故障，否则从位掩码重新生成
  */
-void GraphWithMetadata::ensure_has_subgraphs() const {
-  if (metadata_.has_subgraphs.has_value()) {
+void GraphWithMetadata::sync_graph() const {
+  if (graph_synced_ || !bitset_) {
     return;
   }
+  graph_synced_ = true;
 
-  int num_vertices = static_cast<int>(boost::num_vertices(graph_));
-  if (num_vertices == 0) {
-    metadata_.has_subgraphs = false;
-    check_and_clear_dirty();
+  if (!prototype_) {
+    graph_ = bitset_->to_graph();
     return;
   }
 
-  // 创建新图，只包含未删除的节点和相关的边
-  Graph filtered_g;
-
-  // 建立原图索引到新图顶点的映射
-  std::vector<int> vertex_map(num_vertices, -1);
-
-  // 添加所有未删除的节点
-  for (int i = 0; i < num_vertices; ++i) {
-    auto vertex = boost::vertex(i, graph_);
-    if (!graph_[vertex].is_deleted) {
-      auto new_vertex = boost::add_vertex(filtered_g);
-      filtered_g[new_vertex] = graph_[vertex];
-      vertex_map[i] = static_cast<int>(new_vertex);
+  graph_ = prototype_->graph;
+  int num_vertices = bitset_->num_vertices();
+  for (int v = 0; v < num_vertices; ++v) {
+    if (!bitset_->node_alive(v)) {
+      boost::clear_vertex(v, graph_);
+      graph_[v].is_deleted = true;
     }
   }
-
-  // 添加所有连接未删除节点的边
-  auto [edge_begin, edge_end] = boost::edges(graph_);
-  for (auto it = edge_begin; it != edge_end; ++it) {
-    auto edge = *it;
-    int source_idx = graph_[edge].source_idx;
-    int target_idx = graph_[edge].target_idx;
-
-    // 检查两个节点是否都未删除
-    if (vertex_map[source_idx] != -1 && vertex_map[target_idx] != -1) {
-      auto new_source = boost::vertex(vertex_map[source_idx], filtered_g);
-      auto new_target = boost::vertex(vertex_map[target_idx], filtered_g);
-      auto [new_edge, inserted] =
-          boost::add_edge(new_source, new_target, filtered_g);
-      if (inserted) {
-        filtered_g[new_edge] = graph_[edge];
-      }
+  for (auto [source_idx, target_idx] : prototype_->layout->edge_endpoints) {
+    if (bitset_->node_alive(source_idx) && bitset_->node_alive(target_idx) &&
+        !bitset_->has_edge(source_idx, target_idx)) {
+      boost::remove_edge(source_idx, target_idx, graph_);
     }
   }
+}
 
-  // 计算连通分量
-  int num_vertices_filtered = static_cast<int>(boost::num_vertices(filtered_g));
-  if (num_vertices_filtered == 0) {
-    metadata_.has_subgraphs = false;
-    check_and_clear_dirty();
-    return;
+// 顶点总数（含已删除节点）
+int GraphWithMetadata::num_vertices() const {
+  if (bitset_) {
+    return bitset_->num_vertices();
   }
+  return static_cast<int>(boost::num_vertices(graph_));
+}
 
-  std::vector<int> component(num_vertices_filtered);
-  int num_components =
-      boost::connected_components(filtered_g, component.data());
+// 当前边数
+int GraphWithMetadata::num_edges() const {
+  if (bitset_) {
+    return bitset_->num_edges();
+  }
+  return static_cast<int>(boost::num_edges(graph_));
+}
 
-  // 如果连通分量数量大于1，说明有子图
-  metadata_.has_subgraphs = (num_components > 1);
+// 节点是否存在且未被删除
+bool GraphWithMetadata::node_alive(int node_idx) const {
+  if (bitset_) {
+    return bitset_->node_alive(node_idx);
+  }
+  return node_idx >= 0 && node_idx < num_vertices() &&
+         !graph_[boost::vertex(node_idx, graph_)].is_deleted;
+}
 
-  // 检查是否可以清除脏标记
-  check_and_clear_dirty();
+// 完整图的分数：横纵边数 * 1 + 节点数 * 3
+int GraphWithMetadata::full_score() const {
+  int num_vertices = this->num_vertices();
+  int mesh_size = std::sqrt(num_vertices);
+  return mesh_size * (mesh_size - 1) * 2 + num_vertices * 3;
 }
 
 /**
- * @brief 惰性计算：是否完整
+ * @brief 遍历节点的未删除邻居
+ * @param node_idx 节点索引
+ * @param visit 对每个邻居索引调用的函数
  *
- * 通过比较当前分数与完整图的分数来判断图是否完整
+ * 位压缩后端只检查上下左右四个方向，Boost 后端遍历邻接表
  */
-void GraphWithMetadata::ensure_is_full() const {
-  if (metadata_.is_full.has_value()) {
+template <typename Visitor>
+void GraphWithMetadata::for_each_neighbor(int node_idx, Visitor &&visit) const {
+  if (bitset_) {
+    int N = bitset_->size();
+    for (int w : {node_idx - N, node_idx - 1, node_idx + 1, node_idx + N}) {
+      if (bitset_->has_edge(node_idx, w)) {
+        visit(w);
+      }
+    }
     return;
   }
 
-  int num_vertices = static_cast<int>(boost::num_vertices(graph_));
-  int mesh_size = std::sqrt(num_vertices);
-  int num_edges = mesh_size * (mesh_size - 1) * 2;
-
-  int full_score = num_edges * 1 + num_vertices * 3;
-  int current_score = score(); // 这会触发 ensure_score
-
-  metadata_.is_full = (current_score == full_score);
-
-  // 检查是否可以清除脏标记
-  check_and_clear_dirty();
+  auto [adj_begin, adj_end] = boost::adjacent_vertices(node_idx, graph_);
+  for (auto it = adj_begin; it != adj_end; ++it) {
+    if (!graph_[*it].is_deleted) {
+      visit(static_cast<int>(*it));
+    }
+  }
 }
 
-// 惰性计算：连通分量数量
-void GraphWithMetadata::ensure_num_components() const {
-  if (metadata_.num_components.has_value()) {
-    return;
+// 检查并清除脏标记（当所有属性都已计算时）
+void GraphWithMetadata::check_and_clear_dirty() const {
+  if (metadata_dirty_ && metadata_.has_subgraphs.has_value() &&
+      metadata_.is_full.has_value() && metadata_.num_components.has_value() &&
+      metadata_.score.has_value()) {
+    metadata_dirty_ = false;
   }
+}
 
-  int num_vertices = static_cast<int>(boost::num_vertices(graph_));
-  if (num_vertices == 0) {
-    metadata_.num_components = 0;
-    check_and_clear_dirty();
-    return;
+/**
+ * @brief 单遍计算全部元数据
+ *
+ * 直接在原图上遍历（跳过已删除节点），一次性填充 has_subgraphs、
+ * num_components、score、is_full 和 is_all_nodes_exist，不再构造临时图。
+ * 2..8 的小网格按 graph_size() 分派到 FixedMesh 的编译期特化。
+ *
+ * 位压缩后端的更大网格设置了元数据缓存时，先按规范故障键查找
+ * （元数据在旋转 / 翻转下不变），未命中时计算后写回。
+ * FixedMesh 的单字计算比一次哈希查找还快；Boost 后端求故障键需要先转换，
+ * 代价与直接计算相当，这两种情况都不经过缓存
+ */
+void GraphWithMetadata::evaluate_metadata() const {
+  const int N = static_cast<int>(graph_size_);
+  const bool fixed_size = N >= kFixedMeshMinSize && N <= kFixedMeshMaxSize;
+
+  std::optional<FaultKey> key;
+  if (metadata_cache_ && bitset_ && !fixed_size) {
+    key = canonical_key(fault_key(*bitset_), *mesh_layout(N)).key;
+    if (auto cached = metadata_cache_->find(*key)) {
+      metadata_ = *cached;
+      check_and_clear_dirty();
+      return;
+    }
   }
 
-  // 创建新图，只包含未删除的节点和相关的边
-  Graph filtered_g;
+  // Boost 后端的小网格压成单字掩码，走 FixedMesh 特化
+  std::optional<MeshBitset> converted;
+  const MeshBitset *bits = bitset_ ? &bitset_.value() : nullptr;
+  if (!bits && fixed_size) {
+    converted = MeshBitset::from_graph(graph_);
+    bits = &converted.value();
+  }
 
-  // 建立原图索引到新图顶点的映射
-  std::vector<int> vertex_map(num_vertices, -1);
+  int num_vertices = this->num_vertices();
+  int num_edges = this->num_edges();
 
-  // 添加所有未删除的节点
-  for (int i = 0; i < num_vertices; ++i) {
-    auto vertex = boost::vertex(i, graph_);
-    if (!graph_[vertex].is_deleted) {
-      auto new_vertex = boost::add_vertex(filtered_g);
-      filtered_g[new_vertex] = graph_[vertex];
-      vertex_map[i] = static_cast<int>(new_vertex);
-    }
+  int num_components = 0;
+  int num_alive = 0;
+  if (bits) {
+    num_components = bits->num_components();
+    num_alive = bits->num_alive_nodes();
+  } else {
+    num_components = count_alive_components(graph_, &num_alive);
   }
 
-  // 添加所有连接未删除节点的边
-  auto [edge_begin, edge_end] = boost::edges(graph_);
-  for (auto it = edge_begin; it != edge_end; ++it) {
-    auto edge = *it;
-    int source_idx = graph_[edge].source_idx;
-    int target_idx = graph_[edge].target_idx;
+  int score = num_edges * 1 + num_vertices * 3;
 
-    // 检查两个节点是否都未删除
-    if (vertex_map[source_idx] != -1 && vertex_map[target_idx] != -1) {
-      auto new_source = boost::vertex(vertex_map[source_idx], filtered_g);
-      auto new_target = boost::vertex(vertex_map[target_idx], filtered_g);
-      auto [new_edge, inserted] =
-          boost::add_edge(new_source, new_target, filtered_g);
-      if (inserted) {
-        filtered_g[new_edge] = graph_[edge];
-      }
-    }
-  }
+  metadata_.num_components = num_components;
+  metadata_.has_subgraphs = (num_components > 1); // 连通分量数量大于1，说明有子图
+  metadata_.score = score;
+  metadata_.is_full = (score == full_score());
+  metadata_.is_all_nodes_exist = (num_alive == num_vertices);
 
-  // 计算连通分量
-  int num_vertices_filtered = static_cast<int>(boost::num_vertices(filtered_g));
-  if (num_vertices_filtered == 0) {
-    metadata_.num_components = 0;
-    check_and_clear_dirty();
-    return;
+  if (key) {
+    metadata_cache_->insert(*key, metadata_);
   }
+  check_and_clear_dirty();
+}
 
-  std::vector<int> component(num_vertices_filtered);
-  int num_components =
-      boost::connected_components(filtered_g, component.data());
+/**
+ * @brief 惰性计算：是否有子图
+ *
+ * 通过计算连通分量数量来判断是否存在子图（连通分量数量大于1）
+ */
+void GraphWithMetadata::ensure_has_subgraphs() const {
+  if (!metadata_.has_subgraphs.has_value()) {
+    evaluate_metadata();
+  }
+}
 
-  metadata_.num_components = num_components;
+/**
+ * @brief 惰性计算：是否完整
+ *
+ * 通过比较当前分数与完整图的分数来判断图是否完整
+ */
+void GraphWithMetadata::ensure_is_full() const {
+  if (!metadata_.is_full.has_value()) {
+    evaluate_metadata();
+  }
+}
 
-  // 检查是否可以清除脏标记
-  check_and_clear_dirty();
+// 惰性计算：连通分量数量
+void GraphWithMetadata::ensure_num_components() const {
+  if (!metadata_.num_components.has_value()) {
+    evaluate_metadata();
+  }
 }
 
 /**
@@ -198,17 +224,9 @@ void GraphWithMetadata::ensure_num_components() const {
  * 计算图的分数：边数 * 1 + 节点数 * 3
  */
 void GraphWithMetadata::ensure_score() const {
-  if (metadata_.score.has_value()) {
-    return;
+  if (!metadata_.score.has_value()) {
+    evaluate_metadata();
   }
-
-  int num_vertices = static_cast<int>(boost::num_vertices(graph_));
-  int num_edges = static_cast<int>(boost::num_edges(graph_));
-
-  metadata_.score = num_edges * 1 + num_vertices * 3;
-
-  // 检查是否可以清除脏标记
-  check_and_clear_dirty();
 }
 
 /**
@@ -217,19 +235,9 @@ void GraphWithMetadata::ensure_score() const {
  * 检查图中是否所有节点都未被删除
  */
 void GraphWithMetadata::ensure_is_all_nodes_exist() const {
-  if (metadata_.is_all_nodes_exist.has_value()) {
-    return;
+  if (!metadata_.is_all_nodes_exist.has_value()) {
+    evaluate_metadata();
   }
-
-  int num_vertices = static_cast<int>(boost::num_vertices(graph_));
-  auto ranges = std::views::iota(0, num_vertices);
-  metadata_.is_all_nodes_exist = std::ranges::all_of(ranges, [&](int i) {
-    auto vertex = boost::vertex(i, graph_);
-    return !graph_[vertex].is_deleted;
-  });
-
-  // 检查是否可以清除脏标记
-  check_and_clear_dirty();
 }
 
 //---------------------------------------------------------------
@@ -275,53 +283,113 @@ bool GraphWithMetadata::is_all_nodes_exist() const {
  */
 std::string GraphWithMetadata::get_graph_topology() const {
   std::string topology;
-  size_t node_num = graph_size_ * graph_size_;
+  append_graph_topology(topology);
+  return topology;
+}
 
-  for (size_t i = 0; i < node_num; ++i) {
+/**
+ * @brief 把拓扑结构追加到缓冲区
+ * @param out 输出缓冲区
+ *
+ * 按节点索引升序输出：已删除节点单独一行，未删除节点输出与编号更大的
+ * 未删除邻居之间的边，邻居按编号升序。只遍历实际存在的边，O(V + E)；
+ * 位压缩后端只需检查右侧和下方两条链路，不物化 Boost Graph
+ */
+void GraphWithMetadata::append_graph_topology(std::string &out) const {
+  char buffer[32];
+  auto append_int = [&](int value) {
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, end);
+  };
+  auto append_edge = [&](int i, int j) {
+    out += '\t';
+    append_int(i);
+    out += "--";
+    append_int(j);
+    out += '\n';
+  };
+
+  const int N = static_cast<int>(graph_size_);
+  const int node_num = N * N;
+  if (bitset_) {
+    for (int i = 0; i < node_num; ++i) {
+      if (!bitset_->node_alive(i)) {
+        out += '\t';
+        append_int(i);
+        out += '\n';
+        continue;
+      }
+      if (bitset_->has_edge(i, i + 1)) {
+        append_edge(i, i + 1);
+      }
+      if (bitset_->has_edge(i, i + N)) {
+        append_edge(i, i + N);
+      }
+    }
+    return;
+  }
+
+  std::vector<int> higher;
+  for (int i = 0; i < node_num; ++i) {
     auto vertex_i = boost::vertex(i, graph_);
     if (graph_[vertex_i].is_deleted) {
-      topology += std::format("\t{}\n", i);
+      out += '\t';
+      append_int(i);
+      out += '\n';
       continue;
     }
-    for (size_t j = i + 1; j < node_num; ++j) {
-      auto vertex_j = boost::vertex(j, graph_);
-      if (graph_[vertex_j].is_deleted) {
-        continue;
-      }
-      auto [edge, exists] = boost::edge(vertex_i, vertex_j, graph_);
-      if (exists) {
-        topology += std::format("\t{}--{}\n", i, j);
+    higher.clear();
+    auto [adj_begin, adj_end] = boost::adjacent_vertices(vertex_i, graph_);
+    for (auto it = adj_begin; it != adj_end; ++it) {
+      int j = static_cast<int>(*it);
+      if (j > i && !graph_[*it].is_deleted) {
+        higher.push_back(j);
       }
     }
+    std::ranges::sort(higher);
+    auto [first, last] = std::ranges::unique(higher); // 平行边只输出一次
+    higher.erase(first, last);
+    for (int j : higher) {
+      append_edge(i, j);
+    }
   }
-  return topology;
 }
 
 //---------------------------------------------------------------
 // 修改接口：删除节点
 void GraphWithMetadata::delete_node(int node_idx) {
-  // 检查节点索引是否有效
-  if (node_idx < 0 ||
-      node_idx >= static_cast<int>(boost::num_vertices(graph_))) {
-    return; // 无效索引，直接返回
+  // 检查节点索引是否有效、节点是否已经被删除
+  if (!node_alive(node_idx)) {
+    return; // 无效索引或已删除，直接返回
   }
 
-  // 获取顶点描述符
-  auto vertex = boost::vertex(node_idx, graph_);
-
-  // 检查节点是否已经被删除
-  if (graph_[vertex].is_deleted) {
-    return; // 节点已经被删除，直接返回
+  // 增量模式下先确保元数据已计算，并记下删除前的邻居
+  std::vector<int> neighbors;
+  if (incremental_) {
+    ensure_num_components();
+    for_each_neighbor(node_idx, [&](int w) { neighbors.push_back(w); });
   }
 
-  // 清除与该顶点相关的所有边
-  boost::clear_vertex(vertex, graph_);
+  if (bitset_) {
+    bitset_->delete_node(node_idx);
+    graph_synced_ = false;
+  } else {
+    // 获取顶点描述符
+    auto vertex = boost::vertex(node_idx, graph_);
 
-  // 标记节点为已删除（保留索引，不真正删除节点）
-  graph_[vertex].is_deleted = true;
+    // 清除与该顶点相关的所有边
+    boost::clear_vertex(vertex, graph_);
 
-  // 失效缓存
-  invalidate_metadata();
+    // 标记节点为已删除（保留索引，不真正删除节点）
+    graph_[vertex].is_deleted = true;
+  }
+
+  // 增量更新或失效缓存
+  if (incremental_) {
+    update_after_node_delete(neighbors);
+  } else {
+    invalidate_metadata();
+  }
 }
 
 /**
@@ -329,71 +397,241 @@ void GraphWithMetadata::delete_node(int node_idx) {
  * @param source_idx 源节点索引
  * @param target_idx 目标节点索引
  *
- * 删除指定的边，并失效元数据缓存
+ * 删除指定的边，并失效元数据缓存（增量模式下直接更新元数据）
  */
 void GraphWithMetadata::delete_edge(int source_idx, int target_idx) {
-  // 检查节点索引是否有效
-  int num_vertices = static_cast<int>(boost::num_vertices(graph_));
-  if (source_idx < 0 || source_idx >= num_vertices || target_idx < 0 ||
-      target_idx >= num_vertices) {
-    return; // 无效索引，直接返回
+  // 检查源节点和目标节点是否有效且未被删除
+  if (!node_alive(source_idx) || !node_alive(target_idx)) {
+    return; // 无效索引或节点已被删除，无法删除边
   }
 
-  // 检查源节点和目标节点是否已被删除
-  auto source_vertex = boost::vertex(source_idx, graph_);
-  auto target_vertex = boost::vertex(target_idx, graph_);
-
-  if (graph_[source_vertex].is_deleted || graph_[target_vertex].is_deleted) {
-    return; // 节点已被删除，无法删除边
+  if (incremental_) {
+    ensure_num_components();
   }
 
-  // 获取边描述符
-  auto edge_pair = boost::edge(source_vertex, target_vertex, graph_);
+  if (bitset_) {
+    if (!bitset_->delete_edge(source_idx, target_idx)) {
+      return; // 边不存在
+    }
+    graph_synced_ = false;
+  } else {
+    // 获取边描述符
+    auto source_vertex = boost::vertex(source_idx, graph_);
+    auto target_vertex = boost::vertex(target_idx, graph_);
+    auto edge_pair = boost::edge(source_vertex, target_vertex, graph_);
 
-  // 如果边存在，则删除它
-  if (edge_pair.second) {
+    // 如果边存在，则删除它
+    if (!edge_pair.second) {
+      return;
+    }
     boost::remove_edge(edge_pair.first, graph_);
   }
 
-  // 失效缓存
-  invalidate_metadata();
+  // 增量更新或失效缓存
+  if (incremental_) {
+    update_after_edge_delete(source_idx, target_idx);
+  } else {
+    invalidate_metadata();
+  }
+}
+
+/**
+ * @brief 按边 ID 删除边
+ * @param edge_id 边 ID（编号规则见 MeshLayout）
+ * @return 边 ID 有效时返回 true
+ *
+ * 有布局索引时常数时间定位端点；否则退化为线性查找边属性中的 ID
+ */
+bool GraphWithMetadata::delete_edge_by_id(int edge_id) {
+  if (layout_) {
+    if (edge_id < 0 || edge_id >= layout_->num_edges()) {
+      return false;
+    }
+    auto [source_idx, target_idx] = layout_->edge_endpoints[edge_id];
+    delete_edge(source_idx, target_idx);
+    return true;
+  }
+
+  const Graph &g = graph();
+  auto edges = boost::edges(g);
+  auto found = std::ranges::find_if(
+      std::ranges::subrange(edges.first, edges.second),
+      [&g, edge_id](auto edge) { return g[edge].id == edge_id; });
+  if (found == edges.second) {
+    return false;
+  }
+  delete_edge(g[*found].source_idx, g[*found].target_idx);
+  return true;
 }
 
 // 修改接口：删除孤立节点
 void GraphWithMetadata::delete_isolated_nodes() {
-  boost::graph_traits<Graph>::vertex_iterator vi, vend;
-  boost::tie(vi, vend) = boost::vertices(graph_);
-
-  bool modified = false;
-  std::ranges::for_each(std::ranges::subrange(vi, vend), [&](auto vertex) {
-    if (boost::degree(vertex, graph_) == 0 && !graph_[vertex].is_deleted) {
-      graph_[vertex].is_deleted = true;
-      modified = true;
+  if (incremental_) {
+    ensure_num_components();
+  }
+
+  int removed = 0;
+  if (bitset_) {
+    int alive_before = bitset_->num_alive_nodes();
+    if (bitset_->delete_isolated_nodes()) {
+      graph_synced_ = false;
     }
-  });
+    removed = alive_before - bitset_->num_alive_nodes();
+  } else {
+    boost::graph_traits<Graph>::vertex_iterator vi, vend;
+    boost::tie(vi, vend) = boost::vertices(graph_);
+
+    std::ranges::for_each(std::ranges::subrange(vi, vend), [&](auto vertex) {
+      if (boost::degree(vertex, graph_) == 0 && !graph_[vertex].is_deleted) {
+        graph_[vertex].is_deleted = true;
+        ++removed;
+      }
+    });
+  }
 
-  // 如果修改了图，失效缓存
-  if (modified) {
+  // 如果修改了图，失效缓存；增量模式下每个孤立节点恰好是一个连通分量
+  if (removed == 0) {
+    return;
+  }
+  if (incremental_) {
+    int num_components = metadata_.num_components.value() - removed;
+    metadata_.num_components = num_components;
+    metadata_.has_subgraphs = (num_components > 1);
+    metadata_.is_all_nodes_exist = false;
+  } else {
     invalidate_metadata();
   }
 }
 
 /**
- * @brief 删除随机边
- * @param edge_num 要删除的边数量
+ * @brief 开启增量连通性维护
  *
- * 随机选择并删除指定数量的有效边（连接未删除节点的边）
+ * 先完整计算一次元数据，之后的 delete_node / delete_edge /
+ * delete_isolated_nodes 直接在缓存上更新，不再触发全量重算
  */
-void GraphWithMetadata::remove_random_edges(const int edge_num) {
-  if (edge_num <= 0) {
-    return; // 无效参数，直接返回
+void GraphWithMetadata::enable_incremental_connectivity() {
+  incremental_ = true;
+  ensure_num_components();
+}
+
+/**
+ * @brief 增量模式：删除节点后更新元数据
+ * @param neighbors 被删除节点在删除前的未删除邻居
+ *
+ * 孤立节点被删除时分量数减一；否则原分量可能分裂，
+ * 分裂后的分量数等于邻居中互不连通的组数
+ */
+void GraphWithMetadata::update_after_node_delete(
+    const std::vector<int> &neighbors) const {
+  int num_components = metadata_.num_components.value();
+  if (neighbors.empty()) {
+    num_components -= 1;
+  } else {
+    std::vector<int> representatives;
+    for (int w : neighbors) {
+      bool joined = std::ranges::any_of(
+          representatives, [&](int r) { return is_connected(r, w); });
+      if (!joined) {
+        representatives.push_back(w);
+      }
+    }
+    num_components += static_cast<int>(representatives.size()) - 1;
   }
 
-  // 创建随机数生成器
-  std::random_device rd;
-  std::mt19937 rng(rd());
+  int score = metadata_.score.value() - static_cast<int>(neighbors.size());
+  metadata_.num_components = num_components;
+  metadata_.has_subgraphs = (num_components > 1);
+  metadata_.score = score;
+  metadata_.is_full = (score == full_score());
+  metadata_.is_all_nodes_exist = false;
+}
+
+/**
+ * @brief 增量模式：删除边后更新元数据
+ * @param source_idx 源节点索引
+ * @param target_idx 目标节点索引
+ *
+ * 两端不再连通时说明该边是桥，分量数加一
+ */
+void GraphWithMetadata::update_after_edge_delete(int source_idx,
+                                                 int target_idx) const {
+  int num_components = metadata_.num_components.value();
+  if (!is_connected(source_idx, target_idx)) {
+    num_components += 1;
+  }
+
+  int score = metadata_.score.value() - 1;
+  metadata_.num_components = num_components;
+  metadata_.has_subgraphs = (num_components > 1);
+  metadata_.score = score;
+  metadata_.is_full = (score == full_score());
+}
+
+/**
+ * @brief 双向搜索判断两个节点是否连通
+ * @param source_idx 源节点索引
+ * @param target_idx 目标节点索引
+ * @return 两个节点在同一连通分量时返回 true
+ *
+ * 两侧交替各扩展一个节点，相遇即连通；任一侧先耗尽则不连通，
+ * 因此代价只与较小一侧的分量规模相关
+ */
+bool GraphWithMetadata::is_connected(int source_idx, int target_idx) const {
+  if (source_idx == target_idx) {
+    return true;
+  }
+
+  // 标记只在本次搜索的 base 之上有效，缓冲区只在第一次使用（或回绕）时清零
+  auto &[stamp, queues, base] = search_;
+  if (stamp.size() != static_cast<size_t>(num_vertices()) ||
+      base >= std::numeric_limits<uint32_t>::max() - 2) {
+    stamp.assign(num_vertices(), 0);
+    base = 0;
+  }
+  base += 2;
+  // stamp == base + s 表示由第 s 侧访问
+  const uint32_t first = base;
+  for (auto &queue : queues) {
+    queue.clear();
+  }
+  queues[0].push_back(source_idx);
+  queues[1].push_back(target_idx);
+  size_t heads[2] = {0, 0};
+  stamp[source_idx] = first;
+  stamp[target_idx] = first + 1;
+
+  while (heads[0] < queues[0].size() && heads[1] < queues[1].size()) {
+    for (uint32_t s = 0; s < 2; ++s) {
+      int u = queues[s][heads[s]++];
+      bool met = false;
+      for_each_neighbor(u, [&](int w) {
+        if (stamp[w] < first) {
+          stamp[w] = first + s;
+          queues[s].push_back(w);
+        } else if (stamp[w] != first + s) {
+          met = true;
+        }
+      });
+      if (met) {
+        return true;
+      }
+      if (heads[s] == queues[s].size()) {
+        return false;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 收集所有有效的边
+ * @return 连接两个未删除节点的边 <源节点索引, 目标节点索引>
+ */
+std::vector<std::pair<int, int>> GraphWithMetadata::collect_valid_edges() const {
+  if (bitset_) {
+    return bitset_->edges(); // 链路只会连接存活节点
+  }
 
-  // 收集所有有效的边（连接未删除节点的边）
   std::vector<std::pair<int, int>> valid_edges;
   auto [edge_begin, edge_end] = boost::edges(graph_);
   for (auto it = edge_begin; it != edge_end; ++it) {
@@ -409,6 +647,52 @@ void GraphWithMetadata::remove_random_edges(const int edge_num) {
       valid_edges.emplace_back(source_idx, target_idx);
     }
   }
+  return valid_edges;
+}
+
+/**
+ * @brief 收集所有未删除的节点
+ * @return 未删除节点的索引
+ */
+std::vector<int> GraphWithMetadata::collect_valid_nodes() const {
+  std::vector<int> valid_nodes;
+  int num_vertices = this->num_vertices();
+  for (int i = 0; i < num_vertices; ++i) {
+    bool alive = bitset_ ? bitset_->node_alive(i)
+                         : !graph_[boost::vertex(i, graph_)].is_deleted;
+    if (alive) {
+      valid_nodes.push_back(i);
+    }
+  }
+  return valid_nodes;
+}
+
+/**
+ * @brief 删除随机边
+ * @param edge_num 要删除的边数量
+ *
+ * 随机选择并删除指定数量的有效边（连接未删除节点的边）
+ */
+void GraphWithMetadata::remove_random_edges(const int edge_num) {
+  // 未指定随机流时使用不可复现的种子
+  std::random_device rd;
+  Philox4x32 rng((static_cast<uint64_t>(rd()) << 32) | rd());
+  remove_random_edges(edge_num, rng);
+}
+
+/**
+ * @brief 删除随机边（指定随机流）
+ * @param edge_num 要删除的边数量
+ * @param rng 随机数生成器，相同的流得到相同的结果
+ */
+void GraphWithMetadata::remove_random_edges(const int edge_num,
+                                            Philox4x32 &rng) {
+  if (edge_num <= 0) {
+    return; // 无效参数，直接返回
+  }
+
+  // 收集所有有效的边（连接未删除节点的边）
+  std::vector<std::pair<int, int>> valid_edges = collect_valid_edges();
 
   // 如果有效边数少于要删除的数量，只删除所有有效边
   int num_to_remove = std::min(edge_num, static_cast<int>(valid_edges.size()));
@@ -436,23 +720,25 @@ void GraphWithMetadata::remove_random_edges(const int edge_num) {
  * 随机选择并删除指定数量的未删除节点
  */
 void GraphWithMetadata::remove_random_nodes(const int node_num) {
+  // 未指定随机流时使用不可复现的种子
+  std::random_device rd;
+  Philox4x32 rng((static_cast<uint64_t>(rd()) << 32) | rd());
+  remove_random_nodes(node_num, rng);
+}
+
+/**
+ * @brief 删除随机节点（指定随机流）
+ * @param node_num 要删除的节点数量
+ * @param rng 随机数生成器，相同的流得到相同的结果
+ */
+void GraphWithMetadata::remove_random_nodes(const int node_num,
+                                            Philox4x32 &rng) {
   if (node_num <= 0) {
     return; // 无效参数，直接返回
   }
 
-  // 创建随机数生成器
-  std::random_device rd;
-  std::mt19937 rng(rd());
-
   // 收集所有未删除的节点
-  std::vector<int> valid_nodes;
-  int num_vertices = static_cast<int>(boost::num_vertices(graph_));
-  for (int i = 0; i < num_vertices; ++i) {
-    auto vertex = boost::vertex(i, graph_);
-    if (!graph_[vertex].is_deleted) {
-      valid_nodes.push_back(i);
-    }
-  }
+  std::vector<int> valid_nodes = collect_valid_nodes();
 
   // 如果有效节点数少于要删除的数量，只删除所有有效节点
   int num_to_remove = std::min(node_num, static_cast<int>(valid_nodes.size()));
@@ -8,8 +8,15 @@
 #pragma once
 
 #include "common.h"
+#include "mesh_bitset.h"
+#include "mesh_layout.h"
+#include "philox.h"
+#include <memory>
 #include <optional>
 
+struct MeshPrototype;
+class MetadataCache;
+
 /**
  * @brief 图的元数据结构
  *
@@ -26,22 +33,56 @@ struct GraphMetadata {
 /**
  * @brief 带元数据的图包装类
  *
- * 封装 Boost Graph，提供元数据管理和惰性计算功能
+ * 封装 Boost Graph，提供元数据管理和惰性计算功能。
+ * 也可以包装 MeshBitset 作为后端，此时位掩码是权威状态，
+ * graph() 在需要时才按当前状态物化出 Boost Graph
  */
 class GraphWithMetadata {
 private:
-  Graph graph_;
+  /**
+   * @brief 连通性搜索的临时缓冲区
+   *
+   * stamp[v] >= base 表示节点 v 在本次搜索中已访问；每次搜索把 base 加 2，
+   * 不需要清零。复制图时不复制内容，第一次搜索时才分配
+   */
+  struct SearchScratch {
+    std::vector<uint32_t> stamp;
+    std::vector<int> queues[2];
+    uint32_t base = 0;
+
+    SearchScratch() = default;
+    SearchScratch(const SearchScratch &) {}
+    SearchScratch &operator=(const SearchScratch &) { return *this; }
+    SearchScratch(SearchScratch &&) = default;
+    SearchScratch &operator=(SearchScratch &&) = default;
+  };
+
+  mutable Graph graph_;
   size_t graph_size_;
 
+  std::optional<MeshBitset> bitset_;   // 位压缩后端（存在时优先使用）
+  mutable bool graph_synced_ = true;   // graph_ 是否与 bitset_ 同步
+
+  std::shared_ptr<const MeshLayout> layout_; // 边 ID 查找表（同尺寸共享）
+  std::shared_ptr<const MeshPrototype> prototype_; // 共享的完整网格原型
+
   mutable GraphMetadata metadata_;
   mutable bool metadata_dirty_ = true; // 全局脏标记
 
+  bool incremental_ = false; // 是否增量维护连通性（删除时不清空缓存）
+  mutable SearchScratch search_; // is_connected 复用的缓冲区
+
+  std::shared_ptr<MetadataCache> metadata_cache_; // 按规范故障模式共享的元数据缓存
+
   // 私有方法：清除所有缓存
   void invalidate_metadata() const;
 
   // 私有方法：检查并清除脏标记（当所有属性都已计算时）
   void check_and_clear_dirty() const;
 
+  // 私有方法：单遍计算全部元数据
+  void evaluate_metadata() const;
+
   // 私有方法：惰性计算各个属性
   void ensure_has_subgraphs() const;
   void ensure_is_full() const;
@@ -49,21 +90,93 @@ private:
   void ensure_score() const;
   void ensure_is_all_nodes_exist() const;
 
+  // 私有方法：按位压缩后端的当前状态重建 graph_
+  void sync_graph() const;
+
+  // 私有方法：完整图的分数
+  int full_score() const;
+
+  // 私有方法：遍历节点的未删除邻居（与后端无关）
+  template <typename Visitor>
+  void for_each_neighbor(int node_idx, Visitor &&visit) const;
+
+  // 私有方法：双向搜索判断两个节点当前是否连通
+  bool is_connected(int source_idx, int target_idx) const;
+
+  // 私有方法：增量模式下删除节点/边之后更新元数据
+  void update_after_node_delete(const std::vector<int> &neighbors) const;
+  void update_after_edge_delete(int source_idx, int target_idx) const;
+
 public:
   // 构造和移动
   GraphWithMetadata() = default;
   explicit GraphWithMetadata(Graph g) : graph_(std::move(g)) {
     graph_size_ = static_cast<size_t>(std::sqrt(boost::num_vertices(g)));
   }
+  GraphWithMetadata(Graph g, std::shared_ptr<const MeshLayout> layout)
+      : GraphWithMetadata(std::move(g)) {
+    layout_ = std::move(layout);
+  }
+  explicit GraphWithMetadata(MeshBitset bits)
+      : graph_size_(static_cast<size_t>(bits.size())),
+        bitset_(std::move(bits)), graph_synced_(false),
+        layout_(mesh_layout(static_cast<int>(graph_size_))) {}
+  // 故障叠加层：bits 记录该芯片的故障，prototype 为共享的完整网格
+  GraphWithMetadata(MeshBitset bits,
+                    std::shared_ptr<const MeshPrototype> prototype)
+      : GraphWithMetadata(std::move(bits)) {
+    prototype_ = std::move(prototype);
+  }
 
   // 访问原始图
   size_t graph_size() const { return graph_size_; }
 
-  // 访问原始图（只读）
-  const Graph &graph() const { return graph_; }
+  // 顶点总数（含已删除节点）和当前边数
+  int num_vertices() const;
+  int num_edges() const;
+
+  // 节点是否存在且未被删除
+  bool node_alive(int node_idx) const;
+
+  // 收集有效的边和节点（与后端无关）
+  std::vector<std::pair<int, int>> collect_valid_edges() const;
+  std::vector<int> collect_valid_nodes() const;
+
+  // 开启增量连通性维护：之后的删除操作直接更新元数据而不是清空缓存，
+  // 适合逐个注入故障并在每次注入后查询的场景
+  void enable_incremental_connectivity();
+  bool is_incremental() const { return incremental_; }
+
+  // 使用共享的元数据缓存：计算元数据前先按规范故障键查找，
+  // 未命中时计算后写回；传入 nullptr 关闭。
+  // 只对位压缩后端、FixedMesh 范围（2..8）以外的网格生效
+  void use_metadata_cache(std::shared_ptr<MetadataCache> cache) {
+    metadata_cache_ = std::move(cache);
+  }
+
+  // 访问边 ID 查找表（没有时返回 nullptr）
+  const MeshLayout *layout() const { return layout_.get(); }
+
+  // 是否使用位压缩后端
+  bool is_bitset_backed() const { return bitset_.has_value(); }
+
+  // 访问位压缩后端（只读，未使用时返回 nullptr）
+  const MeshBitset *bitset() const {
+    return bitset_ ? &bitset_.value() : nullptr;
+  }
+
+  // 访问原始图（只读，位压缩后端时按需物化）
+  const Graph &graph() const {
+    sync_graph();
+    return graph_;
+  }
 
   // 访问原始图（可修改，修改后需要标记为脏）
+  // 位压缩后端会先物化再切换为 Boost Graph 后端
   Graph &graph_mut() {
+    sync_graph();
+    bitset_.reset();
+    prototype_.reset();
     invalidate_metadata();
     return graph_;
   }
@@ -71,6 +184,9 @@ public:
   // 输出图的拓扑结构
   std::string get_graph_topology() const;
 
+  // 把拓扑结构追加到 out 末尾（可复用缓冲区）
+  void append_graph_topology(std::string &out) const;
+
   // 获取元数据（惰性计算）
   bool has_subgraphs() const;
   bool is_full() const;
@@ -81,8 +197,13 @@ public:
   // 修改接口（自动更新脏标记）
   void delete_node(int node_idx);
   void delete_edge(int source_idx, int target_idx);
+  bool delete_edge_by_id(int edge_id);
   void delete_isolated_nodes();
 
   void remove_random_edges(const int edge_num);
   void remove_random_nodes(const int node_num);
+
+  // 使用指定的随机流，结果可复现
+  void remove_random_edges(const int edge_num, Philox4x32 &rng);
+  void remove_random_nodes(const int node_num, Philox4x32 &rng);
 };
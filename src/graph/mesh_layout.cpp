@@ -0,0 +1,99 @@
+/**
+ * @file mesh_layout.cpp
+ * @brief 网格布局索引实现
+ *
+ * 实现边 ID 查找表的构建和按网格大小的缓存
+ */
+
+#include "mesh_layout.h"
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @brief 构建网格布局
+ * @param N 网格大小（N x N）
+ *
+ * 先横向边后纵向边，与 generate_mesh_graph_manual 的加边顺序一致；
+ * 同时预先计算 8 个对称变换下节点和边的置换表
+ */
+MeshLayout::MeshLayout(int N) : n(N) {
+  edge_endpoints.reserve(2 * N * (N - 1));
+
+  for (int idx = 0; idx < N * (N - 1); ++idx) {
+    int row = idx / (N - 1);
+    int col = idx % (N - 1);
+    int left_node_idx = row * N + col;
+    edge_endpoints.emplace_back(left_node_idx, left_node_idx + 1);
+  }
+
+  for (int idx = 0; idx < (N - 1) * N; ++idx) {
+    edge_endpoints.emplace_back(idx, idx + N); // 纵向边的上端点索引就是 idx
+  }
+
+  // (row, col) 在各对称变换下的像
+  auto image = [N](int s, int row, int col) {
+    const int r = N - 1 - row;
+    const int c = N - 1 - col;
+    switch (s) {
+    case 1: return col * N + r;
+    case 2: return r * N + c;
+    case 3: return c * N + row;
+    case 4: return row * N + c;
+    case 5: return r * N + col;
+    case 6: return col * N + row;
+    case 7: return c * N + r;
+    default: return row * N + col;
+    }
+  };
+  for (int s = 0; s < kNumSymmetries; ++s) {
+    node_symmetries[s].resize(N * N);
+    for (int v = 0; v < N * N; ++v) {
+      node_symmetries[s][v] = image(s, v / N, v % N);
+    }
+    edge_symmetries[s].resize(edge_endpoints.size());
+    for (size_t e = 0; e < edge_endpoints.size(); ++e) {
+      auto [source_idx, target_idx] = edge_endpoints[e];
+      edge_symmetries[s][e] = edge_id(node_symmetries[s][source_idx],
+                                      node_symmetries[s][target_idx]);
+    }
+  }
+}
+
+/**
+ * @brief 查找两个节点之间的边 ID
+ * @param source_idx 源节点索引
+ * @param target_idx 目标节点索引
+ * @return 边 ID，两个节点不相邻时返回 -1
+ */
+int MeshLayout::edge_id(int source_idx, int target_idx) const {
+  int low = std::min(source_idx, target_idx);
+  int high = std::max(source_idx, target_idx);
+  if (low < 0 || high >= n * n) {
+    return -1;
+  }
+  if (high == low + 1 && low % n < n - 1) {
+    return (low / n) * (n - 1) + low % n;
+  }
+  if (high == low + n) {
+    return n * (n - 1) + low;
+  }
+  return -1;
+}
+
+/**
+ * @brief 获取指定大小的网格布局
+ * @param N 网格大小（N x N）
+ * @return 共享的只读布局
+ */
+std::shared_ptr<const MeshLayout> mesh_layout(int N) {
+  static std::mutex mutex;
+  static std::unordered_map<int, std::shared_ptr<const MeshLayout>> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &layout = cache[N];
+  if (!layout) {
+    layout = std::make_shared<const MeshLayout>(N);
+  }
+  return layout;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file mesh_layout.h
+ * @brief 网格布局索引定义
+ *
+ * 提供边 ID 与端点索引之间的常数时间映射，按网格大小共享
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 网格布局
+ *
+ * 边 ID 的编号与 generate_mesh_graph_manual 一致：
+ * - 横向边 row * (N - 1) + col，连接 (row, col) 和 (row, col + 1)
+ * - 纵向边 N * (N - 1) + row * N + col，连接 (row, col) 和 (row + 1, col)
+ */
+struct MeshLayout {
+  static constexpr int kNumSymmetries = 8; // 正方形网格的二面体群 D4
+
+  int n = 0;                                        // 网格大小 N
+  std::vector<std::pair<int, int>> edge_endpoints; // 边 ID -> <源节点, 目标节点>
+
+  // 第 s 个对称变换下节点 / 边的像，s = 0 为恒等变换，
+  // 1..3 为旋转 90/180/270 度，4..7 为水平、垂直、主对角线、副对角线翻转
+  std::array<std::vector<int>, kNumSymmetries> node_symmetries;
+  std::array<std::vector<int>, kNumSymmetries> edge_symmetries;
+
+  explicit MeshLayout(int N);
+
+  int num_vertices() const { return n * n; }
+  int num_edges() const { return static_cast<int>(edge_endpoints.size()); }
+
+  // 两个节点之间的边 ID，不相邻时返回 -1
+  int edge_id(int source_idx, int target_idx) const;
+};
+
+/**
+ * @brief 获取指定大小的网格布局
+ * @param N 网格大小（N x N）
+ * @return 共享的只读布局，同一大小只构建一次（线程安全）
+ */
+std::shared_ptr<const MeshLayout> mesh_layout(int N);
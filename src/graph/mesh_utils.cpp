@@ -6,6 +6,8 @@
  */
 
 #include "mesh_utils.h"
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 
 /**
  * @brief 打印网格图
@@ -120,63 +122,59 @@ int count_mesh_score(const Graph &g) {
 }
 
 /**
- * @brief 检查图是否有子图
- * @param g 要检查的图
- * @return 如果存在子图返回 true，否则返回 false
+ * @brief 统计未删除节点构成的连通分量
+ * @param g 要统计的图
+ * @param num_alive 输出未删除节点的数量（可为 nullptr）
+ * @return 连通分量数量，没有未删除节点时返回 0
+ *
+ * 直接在原图上做深度优先遍历并跳过已删除节点，不复制节点和边
  */
-bool has_subgraphs(const Graph &g) {
+int count_alive_components(const Graph &g, int *num_alive) {
   int num_vertices = static_cast<int>(boost::num_vertices(g));
-  if (num_vertices == 0) {
-    return false; // 空图没有子图
-  }
-
-  // 创建新图，只包含未删除的节点和相关的边
-  Graph filtered_g;
-
-  // 建立原图索引到新图顶点的映射
-  std::vector<int> vertex_map(num_vertices, -1);
+  std::vector<char> visited(num_vertices, 0);
+  std::vector<int> stack;
+  stack.reserve(num_vertices);
 
-  // 添加所有未删除的节点
+  int num_components = 0;
+  int alive = 0;
   for (int i = 0; i < num_vertices; ++i) {
-    auto vertex = boost::vertex(i, g);
-    if (!g[vertex].is_deleted) {
-      auto new_vertex = boost::add_vertex(filtered_g);
-      filtered_g[new_vertex] = g[vertex];
-      vertex_map[i] = static_cast<int>(new_vertex);
+    if (visited[i] || g[boost::vertex(i, g)].is_deleted) {
+      continue;
     }
-  }
-
-  // 添加所有连接未删除节点的边
-  auto [edge_begin, edge_end] = boost::edges(g);
-  for (auto it = edge_begin; it != edge_end; ++it) {
-    auto edge = *it;
-    int source_idx = g[edge].source_idx;
-    int target_idx = g[edge].target_idx;
-
-    // 检查两个节点是否都未删除
-    if (vertex_map[source_idx] != -1 && vertex_map[target_idx] != -1) {
-      auto new_source = boost::vertex(vertex_map[source_idx], filtered_g);
-      auto new_target = boost::vertex(vertex_map[target_idx], filtered_g);
-      auto [new_edge, inserted] =
-          boost::add_edge(new_source, new_target, filtered_g);
-      if (inserted) {
-        filtered_g[new_edge] = g[edge];
+    ++num_components;
+    visited[i] = 1;
+    stack.push_back(i);
+
+    while (!stack.empty()) {
+      int u = stack.back();
+      stack.pop_back();
+      ++alive;
+
+      auto [adj_begin, adj_end] = boost::adjacent_vertices(u, g);
+      for (auto it = adj_begin; it != adj_end; ++it) {
+        int w = static_cast<int>(*it);
+        if (!visited[w] && !g[*it].is_deleted) {
+          visited[w] = 1;
+          stack.push_back(w);
+        }
       }
     }
   }
 
-  // 计算连通分量
-  int num_vertices_filtered = static_cast<int>(boost::num_vertices(filtered_g));
-  if (num_vertices_filtered == 0) {
-    return false; // 没有有效节点
+  if (num_alive != nullptr) {
+    *num_alive = alive;
   }
+  return num_components;
+}
 
-  std::vector<int> component(num_vertices_filtered);
-  int num_components =
-      boost::connected_components(filtered_g, component.data());
-
+/**
+ * @brief 检查图是否有子图
+ * @param g 要检查的图
+ * @return 如果存在子图返回 true，否则返回 false
+ */
+bool has_subgraphs(const Graph &g) {
   // 如果连通分量数量大于1，说明有子图
-  return num_components > 1;
+  return count_alive_components(g) > 1;
 }
 
 bool is_graph_full(const Graph &g) {
@@ -234,18 +232,59 @@ void generate_topology(const std::filesystem::path &file_path,
     LOG_INFO("已删除旧文件: {}", file_path.string());
   }
 
-  std::ofstream outfile(file_path);
+  std::string content;
+  format_topology(content, name, weight, pipeline_stage_delay, g);
+  write_topology_file(file_path, content);
+}
+
+void format_topology(std::string &out, const std::string &name,
+                     const int weight, const int pipeline_stage_delay,
+                     const GraphWithMetadata &g) {
+  std::format_to(std::back_inserter(out),
+                 "graph {} {{\n\tedge[weight={}]\n\tnode[pipeline_stage_delay={}]\n",
+                 name, weight, pipeline_stage_delay);
+  g.append_graph_topology(out);
+  out += "}\n";
+}
+
+void write_topology_file(const std::filesystem::path &file_path,
+                         std::string_view content) {
+  std::ofstream outfile(file_path, std::ios::binary | std::ios::trunc);
+  outfile.write(content.data(), static_cast<std::streamsize>(content.size()));
+  if (!outfile) {
+    LOG_ERROR("无法写入文件: {}", file_path.string());
+  }
+}
+
+namespace {
 
-  std::string topology = g.get_graph_topology();
-  std::string ss;
-  ss += std::format("graph {} {{\n", name);
-  ss += std::format("\tedge[weight={}]\n", weight);
-  ss += std::format("\tnode[pipeline_stage_delay={}]\n", pipeline_stage_delay);
-  ss += topology;
-  ss += std::format("}}\n");
-  std::print(outfile, "{}", ss);
+/**
+ * @brief 并行写出 graph_0.gv ... graph_{count-1}.gv
+ * @param count 文件数量
+ * @param graph_at 第 idx 个文件对应的图
+ * @param base_path 输出目录
+ * @param weight 边权重
+ * @param pipeline_stage_delay 流水线阶段延迟
+ *
+ * 目录只创建一次；每个线程复用自己的缓冲区，每个文件格式化后一次写出
+ */
+template <typename GraphAt>
+void write_topology_files(size_t count, GraphAt graph_at,
+                          const std::filesystem::path &base_path,
+                          const int weight, const int pipeline_stage_delay) {
+  std::filesystem::create_directories(base_path);
+  tbb::enumerable_thread_specific<std::string> buffers;
+  tbb::parallel_for(size_t{0}, count, [&](size_t idx) {
+    std::string &buffer = buffers.local();
+    buffer.clear();
+    format_topology(buffer, std::format("graph_{}", idx), weight,
+                    pipeline_stage_delay, graph_at(idx));
+    write_topology_file(base_path / std::format("graph_{}.gv", idx), buffer);
+  });
 }
 
+} // namespace
+
 /**
  * @brief 批量生成图的拓扑结构文件
  * @param graphs 图向量
@@ -254,17 +293,44 @@ void generate_topology(const std::filesystem::path &file_path,
  * @param pipeline_stage_delay 流水线阶段延迟（默认值为1）
  *
  * 为向量中的每个图生成一个拓扑文件，文件名为 graph_0.gv, graph_1.gv, ...
+ * 已有的同名文件直接覆盖
  */
 void generate_topology_batch(const std::vector<GraphWithMetadata> &graphs,
                               const std::filesystem::path &base_path,
                               const int weight,
                               const int pipeline_stage_delay) {
-  int idx = 0;
-  for (const auto &g : graphs) {
-    std::string file_name = std::format("graph_{}.gv", idx);
-    std::string graph_name = std::format("graph_{}", idx);
-    std::filesystem::path file_path = base_path / file_name;
-    generate_topology(file_path, graph_name, weight, pipeline_stage_delay, g);
-    ++idx;
+  write_topology_files(
+      graphs.size(), [&](size_t idx) -> const auto & { return graphs[idx]; },
+      base_path, weight, pipeline_stage_delay);
+}
+
+/**
+ * @brief 按对称去重结果批量生成拓扑结构文件
+ * @param graphs 图向量
+ * @param groups 对称类分组
+ * @param base_path 输出文件的基础路径（目录）
+ * @param weight 边权重
+ * @param pipeline_stage_delay 流水线阶段延迟
+ *
+ * multiplicity.csv 的格式为 file,multiplicity
+ */
+void generate_topology_batch(const std::vector<GraphWithMetadata> &graphs,
+                             const std::vector<SymmetryGroup> &groups,
+                             const std::filesystem::path &base_path,
+                             const int weight,
+                             const int pipeline_stage_delay) {
+  write_topology_files(
+      groups.size(),
+      [&](size_t idx) -> const auto & {
+        return graphs[groups[idx].representative];
+      },
+      base_path, weight, pipeline_stage_delay);
+
+  std::string manifest = "file,multiplicity\n";
+  for (size_t idx = 0; idx < groups.size(); ++idx) {
+    std::format_to(std::back_inserter(manifest), "graph_{}.gv,{}\n", idx,
+                   groups[idx].multiplicity);
   }
-}
\ No newline at end of file
+  write_topology_file(base_path / "multiplicity.csv", manifest);
+  LOG_INFO("{} 个芯片去重为 {} 个拓扑文件", graphs.size(), groups.size());
+}
@@ -9,11 +9,16 @@
 
 #include "Log.h"
 #include "common.h"
+#include "fault_pattern.h"
 #include "mesh.h"
 #include <algorithm>
 #include <cmath>
 #include <filesystem> // C++17 标准库
+#include <format>
 #include <fstream>
+#include <ranges>
+#include <string>
+#include <string_view>
 #include <vector>
 
 /**
@@ -29,6 +34,14 @@ void print_mesh_graph(const Graph &g);
  */
 int count_mesh_score(const Graph &g);
 
+/**
+ * @brief 统计未删除节点构成的连通分量
+ * @param g 要统计的图
+ * @param num_alive 输出未删除节点的数量（可为 nullptr）
+ * @return 连通分量数量，没有未删除节点时返回 0
+ */
+int count_alive_components(const Graph &g, int *num_alive = nullptr);
+
 /**
  * @brief 检查图是否有子图
  * @param g 要检查的图
@@ -62,6 +75,26 @@ void generate_topology(const std::filesystem::path &file_path,
                        const int pipeline_stage_delay,
                        const GraphWithMetadata &g);
 
+/**
+ * @brief 把 GraphViz 格式的拓扑文件内容追加到缓冲区
+ * @param out 输出缓冲区
+ * @param name 图名称
+ * @param weight 边权重
+ * @param pipeline_stage_delay 流水线阶段延迟
+ * @param g 要生成拓扑的图
+ */
+void format_topology(std::string &out, const std::string &name,
+                     const int weight, const int pipeline_stage_delay,
+                     const GraphWithMetadata &g);
+
+/**
+ * @brief 把缓冲区一次写入文件（覆盖已有文件，不检查目录）
+ * @param file_path 输出文件路径
+ * @param content 文件内容
+ */
+void write_topology_file(const std::filesystem::path &file_path,
+                         std::string_view content);
+
 /**
  * @brief 批量生成图的拓扑结构文件
  * @param graphs 图向量
@@ -70,8 +103,53 @@ void generate_topology(const std::filesystem::path &file_path,
  * @param pipeline_stage_delay 流水线阶段延迟（默认值为1）
  *
  * 为向量中的每个图生成一个拓扑文件，文件名为 graph_0.gv, graph_1.gv, ...
+ * 目录只创建一次，各文件在 TBB 线程池上并行格式化和写出
+ */
+void generate_topology_batch(const std::vector<GraphWithMetadata> &graphs,
+                             const std::filesystem::path &base_path,
+                             const int weight = 1,
+                             const int pipeline_stage_delay = 1);
+/**
+ * @brief 按对称去重结果批量生成拓扑结构文件
+ * @param graphs 图向量（dedup_by_symmetry 的输入）
+ * @param groups dedup_by_symmetry 的结果
+ * @param base_path 输出文件的基础路径（目录）
+ * @param weight 边权重（默认值为1）
+ * @param pipeline_stage_delay 流水线阶段延迟（默认值为1）
+ *
+ * 每个对称类只为代表生成 graph_i.gv，另写 multiplicity.csv 记录
+ * 每个文件代表的芯片数量，下游仿真结果按该数量加权即可还原全部芯片
  */
 void generate_topology_batch(const std::vector<GraphWithMetadata> &graphs,
+                             const std::vector<SymmetryGroup> &groups,
                              const std::filesystem::path &base_path,
                              const int weight = 1,
-                             const int pipeline_stage_delay = 1);
\ No newline at end of file
+                             const int pipeline_stage_delay = 1);
+
+/**
+ * @brief 流式生成拓扑结构文件
+ * @param graphs 任意输入范围（例如 chip_stream 加过滤），每个元素只访问一次
+ * @param base_path 输出文件的基础路径（目录）
+ * @param weight 边权重（默认值为1）
+ * @param pipeline_stage_delay 流水线阶段延迟（默认值为1）
+ * @return 生成的文件数量
+ *
+ * 边遍历边写出 graph_0.gv, graph_1.gv, ...，不保存整批图
+ */
+template <std::ranges::input_range R>
+size_t generate_topology_stream(R &&graphs,
+                                const std::filesystem::path &base_path,
+                                const int weight = 1,
+                                const int pipeline_stage_delay = 1) {
+  std::filesystem::create_directories(base_path);
+  std::string buffer;
+  size_t idx = 0;
+  for (auto &&g : graphs) {
+    buffer.clear();
+    format_topology(buffer, std::format("graph_{}", idx), weight,
+                    pipeline_stage_delay, g);
+    write_topology_file(base_path / std::format("graph_{}.gv", idx), buffer);
+    ++idx;
+  }
+  return idx;
+}
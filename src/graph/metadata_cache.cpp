@@ -0,0 +1,87 @@
+/**
+ * @file metadata_cache.cpp
+ * @brief 按规范故障模式缓存元数据的实现
+ *
+ * 实现分片加锁的查找、先进先出淘汰和命中统计
+ */
+
+#include "metadata_cache.h"
+#include <algorithm>
+#include <mutex>
+
+double MetadataCacheStats::hit_rate() const {
+  uint64_t lookups = hits + misses;
+  return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+}
+
+MetadataCache::MetadataCache(size_t capacity, size_t num_shards) {
+  num_shards = std::max<size_t>(1, num_shards);
+  shard_capacity_ = std::max<size_t>(1, capacity / num_shards);
+  shards_.reserve(num_shards);
+  for (size_t i = 0; i < num_shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+// 分片用哈希的高位选择，低位留给分片内的哈希表
+MetadataCache::Shard &MetadataCache::shard_for(const FaultKey &key) const {
+  return *shards_[(key.hash() >> 32) % shards_.size()];
+}
+
+std::optional<GraphMetadata> MetadataCache::find(const FaultKey &key) const {
+  Shard &shard = shard_for(key);
+  {
+    std::shared_lock lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end()) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return it->second;
+    }
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return std::nullopt;
+}
+
+/**
+ * @brief 插入元数据
+ * @param key 规范故障键
+ * @param metadata 完整计算过的元数据
+ *
+ * 多个线程同时算出同一个键时只保留第一个，结果相同
+ */
+void MetadataCache::insert(const FaultKey &key, const GraphMetadata &metadata) {
+  Shard &shard = shard_for(key);
+  std::unique_lock lock(shard.mutex);
+  if (!shard.entries.try_emplace(key, metadata).second) {
+    return;
+  }
+  shard.insertion_order.push_back(key);
+  while (shard.entries.size() > shard_capacity_) {
+    shard.entries.erase(shard.insertion_order.front());
+    shard.insertion_order.pop_front();
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+MetadataCacheStats MetadataCache::stats() const {
+  MetadataCacheStats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  stats.evictions = evictions_.load(std::memory_order_relaxed);
+  for (const auto &shard : shards_) {
+    std::shared_lock lock(shard->mutex);
+    stats.size += shard->entries.size();
+  }
+  return stats;
+}
+
+void MetadataCache::clear() {
+  for (const auto &shard : shards_) {
+    std::unique_lock lock(shard->mutex);
+    shard->entries.clear();
+    shard->insertion_order.clear();
+  }
+  hits_ = 0;
+  misses_ = 0;
+  evictions_ = 0;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file metadata_cache.h
+ * @brief 按规范故障模式缓存元数据的声明
+ *
+ * 低错误率下同样的小故障模式（一条坏链路、一个坏角节点……）在不同芯片、
+ * 不同扫描格子中反复出现。连通分量数量、分数等元数据在旋转 / 翻转下不变，
+ * 因此可以按规范故障键缓存，重复的模式只需要一次哈希查找
+ */
+
+#pragma once
+
+#include "fault_pattern.h"
+#include "mesh_data.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 缓存统计
+ */
+struct MetadataCacheStats {
+  uint64_t hits = 0;      // 命中次数
+  uint64_t misses = 0;    // 未命中次数
+  uint64_t evictions = 0; // 因容量淘汰的条目数
+  size_t size = 0;        // 当前条目数
+
+  double hit_rate() const; // 命中率（0.0-1.0），没有查询时为 0
+};
+
+/**
+ * @brief 线程安全的有界元数据缓存
+ *
+ * 按键的哈希分成若干分片，每个分片一把读写锁：查找只加共享锁，
+ * 插入时分片已满则按先进先出淘汰最早的条目。多个芯片、多个线程可以
+ * 通过 shared_ptr 共享同一个缓存
+ */
+class MetadataCache {
+private:
+  struct Shard {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<FaultKey, GraphMetadata> entries;
+    std::deque<FaultKey> insertion_order; // 先进先出淘汰顺序
+  };
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  size_t shard_capacity_;
+
+  mutable std::atomic<uint64_t> hits_{0};
+  mutable std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+
+  Shard &shard_for(const FaultKey &key) const;
+
+public:
+  /**
+   * @brief 构造缓存
+   * @param capacity 最大条目数（平均分到各分片，至少每片 1 条）
+   * @param num_shards 分片数量
+   */
+  explicit MetadataCache(size_t capacity = 1 << 20, size_t num_shards = 64);
+
+  // 查找规范故障键对应的元数据，同时更新命中 / 未命中计数
+  std::optional<GraphMetadata> find(const FaultKey &key) const;
+
+  // 插入元数据（已存在时保留原值）
+  void insert(const FaultKey &key, const GraphMetadata &metadata);
+
+  MetadataCacheStats stats() const;
+
+  // 清空条目和计数
+  void clear();
+};
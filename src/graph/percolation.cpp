@@ -0,0 +1,183 @@
+/**
+ * @file percolation.cpp
+ * @brief Newman–Ziff 渗流模式实现
+ *
+ * 实现单个芯片的渗流阈值计算、并行抽样以及按二项分布混合的曲线查询
+ */
+
+#include "percolation.h"
+#include "conditional_yield.h"
+#include "error_inject.h"
+#include "fault_sampler.h"
+#include "mesh.h"
+#include <algorithm>
+#include <boost/pending/disjoint_sets.hpp>
+#include <cmath>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+/**
+ * @brief 单个芯片的渗流阈值
+ * @param g 芯片
+ * @param rng 随机数生成器
+ * @return 第一次没有子图时已加入的链路数量，永远无法连通时返回 E + 1
+ */
+int percolation_threshold(const GraphWithMetadata &g, Philox4x32 &rng) {
+  const int N = static_cast<int>(g.graph_size());
+  std::shared_ptr<const MeshLayout> shared_layout;
+  const MeshLayout *layout = g.layout();
+  if (layout == nullptr) {
+    shared_layout = mesh_layout(N);
+    layout = shared_layout.get();
+  }
+
+  const int num_vertices = layout->num_vertices();
+  const int num_edges = layout->num_edges();
+
+  std::vector<char> alive(num_vertices);
+  int num_components = 0;
+  for (int v = 0; v < num_vertices; ++v) {
+    alive[v] = g.node_alive(v);
+    num_components += alive[v];
+  }
+  if (num_components <= 1) {
+    return 0;
+  }
+
+  // 链路的随机加入顺序
+  std::vector<int> order(num_edges);
+  for (int e = 0; e < num_edges; ++e) {
+    order[e] = e;
+  }
+  std::ranges::shuffle(order, rng);
+
+  boost::disjoint_sets_with_storage<> sets(num_vertices);
+  for (int v = 0; v < num_vertices; ++v) {
+    sets.make_set(v);
+  }
+  for (int m = 0; m < num_edges; ++m) {
+    auto [source_idx, target_idx] = layout->edge_endpoints[order[m]];
+    if (!alive[source_idx] || !alive[target_idx]) {
+      continue;
+    }
+    int root_source = sets.find_set(source_idx);
+    int root_target = sets.find_set(target_idx);
+    if (root_source != root_target) {
+      sets.link(root_source, root_target);
+      if (--num_components == 1) {
+        return m + 1;
+      }
+    }
+  }
+  return num_edges + 1;
+}
+
+/**
+ * @brief 抽样构建渗流曲线
+ * @param config 配置
+ *
+ * 第 c 个芯片先用 chip_fault_rng(seed, k, 0, c) 按节点错误率注入节点故障，
+ * 再用同一随机流决定链路的加入顺序；芯片之间互相独立，交给 TBB 并行计算
+ */
+PercolationCurve::PercolationCurve(const PercolationConfig &config)
+    : mesh_size_(config.mesh_size), node_error_rate_(config.node_error_rate),
+      num_samples_(std::max(0, config.num_samples)) {
+  const int N = mesh_size_;
+  const int V = N * N;
+  const int E = 2 * N * (N - 1);
+
+  std::vector<int> thresholds(num_samples_);
+  std::vector<char> all_nodes_exist(num_samples_);
+
+  auto run_chip = [&](int c) {
+    GraphWithMetadata g = generate_mesh_bitset(N);
+    Philox4x32 rng = chip_fault_rng(config.seed, N, 0, c);
+    sample_bernoulli(V, node_error_rate_, rng, [&g](int64_t v) {
+      g.delete_node(static_cast<int>(v));
+    });
+    all_nodes_exist[c] = g.is_all_nodes_exist();
+    thresholds[c] = percolation_threshold(g, rng);
+  };
+
+  tbb::task_arena arena(config.num_threads > 0 ? config.num_threads
+                                               : tbb::task_arena::automatic);
+  arena.execute([&] {
+    tbb::parallel_for(tbb::blocked_range<int>(0, num_samples_),
+                      [&](const tbb::blocked_range<int> &range) {
+                        for (int c = range.begin(); c != range.end(); ++c) {
+                          run_chip(c);
+                        }
+                      });
+  });
+
+  connected_at_.assign(E + 2, 0);
+  for (int c = 0; c < num_samples_; ++c) {
+    ++connected_at_[thresholds[c]];
+    num_all_nodes_exist_ += all_nodes_exist[c];
+  }
+}
+
+double PercolationCurve::connected_probability(int num_links) const {
+  if (num_samples_ == 0) {
+    return 0.0;
+  }
+  int last = std::min(num_links, static_cast<int>(connected_at_.size()) - 2);
+  int connected = 0;
+  for (int m = 0; m <= last; ++m) {
+    connected += connected_at_[m];
+  }
+  return static_cast<double>(connected) / num_samples_;
+}
+
+/**
+ * @brief 给定边错误率下的良率估计
+ * @param edge_error_rate 边错误率（0.0-1.0）
+ * @return 良率估计（百分比）
+ */
+YieldEstimate PercolationCurve::estimate(float edge_error_rate) const {
+  return sweep({edge_error_rate}).front();
+}
+
+/**
+ * @brief 一组边错误率下的良率估计
+ * @param edge_error_rates 边错误率
+ * @return 良率估计（百分比），顺序与 edge_error_rates 一致
+ *
+ * 坏链路数 b 服从 Binomial(E, p)：
+ * - sub_graphs_rate = sum_b P(b) (1 - connected_probability(E - b))
+ * - incomplete_graphs_rate = 1 - P(没有坏节点) (1 - p)^E
+ */
+std::vector<YieldEstimate>
+PercolationCurve::sweep(const std::vector<float> &edge_error_rates) const {
+  const int E = 2 * mesh_size_ * (mesh_size_ - 1);
+
+  // 前缀和：connected[m] 为 m 条链路存在时没有子图的芯片比例
+  std::vector<double> connected(E + 1, 0.0);
+  if (num_samples_ > 0) {
+    int running = 0;
+    for (int m = 0; m <= E; ++m) {
+      running += connected_at_[m];
+      connected[m] = static_cast<double>(running) / num_samples_;
+    }
+  }
+  double all_nodes_exist =
+      num_samples_ == 0
+          ? 0.0
+          : static_cast<double>(num_all_nodes_exist_) / num_samples_;
+
+  std::vector<YieldEstimate> estimates;
+  estimates.reserve(edge_error_rates.size());
+  for (float rate : edge_error_rates) {
+    std::vector<double> pmf = binomial_pmf(E, rate);
+    double sub_graphs = 0.0;
+    for (int b = 0; b <= E; ++b) {
+      sub_graphs += pmf[b] * (1.0 - connected[E - b]);
+    }
+    double incomplete = 1.0 - all_nodes_exist * pmf[0];
+    estimates.push_back(YieldEstimate{mesh_size_, node_error_rate_, rate,
+                                      static_cast<float>(sub_graphs * 100),
+                                      static_cast<float>(incomplete * 100)});
+  }
+  return estimates;
+}
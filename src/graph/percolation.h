@@ -0,0 +1,69 @@
+/**
+ * @file percolation.h
+ * @brief Newman–Ziff 渗流模式声明
+ *
+ * 固定节点错误率，把每个芯片的链路按随机顺序逐条加入，用并查集记录芯片
+ * 变为连通时已加入的链路数量，一组样本即可给出任意边错误率下的良率曲线
+ */
+
+#pragma once
+
+#include "mesh_data.h"
+#include "philox.h"
+#include "yield_sweep.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 渗流模式配置
+ */
+struct PercolationConfig {
+  int mesh_size = 4;            // 网格大小 k（k x k）
+  float node_error_rate = 0.0f; // 固定的节点错误率（0.0-1.0）
+  int num_samples = 10000;      // 芯片数量
+  uint64_t seed = 42;           // 随机种子
+  int num_threads = 0;          // 工作线程数，0 表示使用全部核心
+};
+
+/**
+ * @brief 单个芯片的渗流阈值
+ * @param g 芯片（只使用节点的存活状态，链路从空开始逐条加入）
+ * @param rng 随机数生成器，决定链路的加入顺序
+ * @return 按随机顺序加入完整网格的链路时，未删除节点第一次构成至多一个
+ *         连通分量时已加入的链路数量
+ *
+ * 一端节点已删除的链路加入时没有效果，但仍然计入链路数量，
+ * 与按边 ID 均匀注入链路故障的语义一致
+ */
+int percolation_threshold(const GraphWithMetadata &g, Philox4x32 &rng);
+
+/**
+ * @brief 渗流良率曲线
+ *
+ * 链路出错数为 b 时芯片存在子图，当且仅当前 E - b 条链路不足以连通，
+ * 因此 P(has_subgraphs | b) 就是阈值大于 E - b 的芯片比例，
+ * 再按二项分布混合得到任意边错误率下的结果
+ */
+class PercolationCurve {
+private:
+  int mesh_size_ = 0;
+  float node_error_rate_ = 0.0f;
+  int num_samples_ = 0;
+  int num_all_nodes_exist_ = 0;   // 没有坏节点的芯片数量
+  std::vector<int> connected_at_; // 第 m 项：阈值恰好为 m 的芯片数量
+
+public:
+  explicit PercolationCurve(const PercolationConfig &config);
+
+  int mesh_size() const { return mesh_size_; }
+  float node_error_rate() const { return node_error_rate_; }
+  int num_samples() const { return num_samples_; }
+
+  // 恰好有 num_links 条链路存在时没有子图的概率
+  double connected_probability(int num_links) const;
+
+  // 给定边错误率下的良率估计（百分比）
+  YieldEstimate estimate(float edge_error_rate) const;
+  std::vector<YieldEstimate>
+  sweep(const std::vector<float> &edge_error_rates) const;
+};
@@ -0,0 +1,331 @@
+/**
+ * @file reliability.cpp
+ * @brief 小网格的精确全端可靠度实现
+ *
+ * 前沿状态：每列一个槽位，记录该列最近处理的节点是否存活以及所属连通分量的
+ * 规范化标签，另有一个标志表示某个连通分量已经离开前沿（此后不能再有存活节点）。
+ * 每个状态保存一个以 (坏节点数, 坏链路数) 为下标的组合计数表
+ */
+
+#include "reliability.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+constexpr int kDead = -1;      // 槽位节点已删除（或还没有节点）
+constexpr int kFresh = 1000;   // 新节点的临时标签
+constexpr int kMaxWidth = 15;  // 4 位编码标签，15 表示删除
+
+/**
+ * @brief 前沿状态
+ */
+struct Frontier {
+  std::vector<int> slots; // 每列的标签，kDead 表示删除
+  bool closed = false;    // 是否已有连通分量离开前沿
+
+  // 按首次出现的顺序重新编号，保证同构状态编码相同
+  void canonicalize() {
+    int relabel[kFresh + 1];
+    std::fill(std::begin(relabel), std::end(relabel), -1);
+    int next = 0;
+    for (int &label : slots) {
+      if (label == kDead) {
+        continue;
+      }
+      if (relabel[label] < 0) {
+        relabel[label] = next++;
+      }
+      label = relabel[label];
+    }
+  }
+
+  uint64_t encode() const {
+    uint64_t key = closed ? 1 : 0;
+    for (int label : slots) {
+      key = (key << 4) | static_cast<uint64_t>(label == kDead ? 15 : label);
+    }
+    return key;
+  }
+
+  static Frontier decode(uint64_t key, int width) {
+    Frontier f;
+    f.slots.resize(width);
+    for (int j = width - 1; j >= 0; --j) {
+      int label = static_cast<int>(key & 15);
+      f.slots[j] = label == 15 ? kDead : label;
+      key >>= 4;
+    }
+    f.closed = key & 1;
+    return f;
+  }
+
+  bool contains(int label) const {
+    return std::ranges::find(slots, label) != slots.end();
+  }
+
+  bool any_alive() const {
+    return std::ranges::any_of(slots, [](int l) { return l != kDead; });
+  }
+
+  void merge(int from, int to) {
+    std::ranges::replace(slots, from, to);
+  }
+};
+
+/**
+ * @brief 组合计数表的累加器
+ *
+ * 计数表按 a * (E + 1) + b 存放；只遍历当前可能非零的范围
+ */
+struct CountTable {
+  int num_edges;
+  int max_a; // 已处理节点数
+  int max_b; // 已处理链路数
+
+  // dst += src * x_node^da * x_edge^dead_links * (1 + x_edge)^free_links
+  void add(std::vector<double> &dst, const std::vector<double> &src, int da,
+           int dead_links, int free_links) const {
+    static constexpr double kBinomial[3][3] = {{1, 0, 0}, {1, 1, 0}, {1, 2, 1}};
+    const int stride = num_edges + 1;
+    for (int a = 0; a <= max_a; ++a) {
+      for (int b = 0; b <= max_b; ++b) {
+        double value = src[a * stride + b];
+        if (value == 0.0) {
+          continue;
+        }
+        double *out = &dst[(a + da) * stride + b + dead_links];
+        for (int j = 0; j <= free_links; ++j) {
+          out[j] += value * kBinomial[free_links][j];
+        }
+      }
+    }
+  }
+};
+
+} // namespace
+
+/**
+ * @brief 构建可靠度多项式
+ * @param N 网格大小（N x N，1 <= N <= 15）
+ *
+ * 节点 (r, c) 处理时，槽位 c 中是 (r - 1, c)，槽位 c - 1 中是 (r, c - 1)。
+ * 依次决定新节点、向上链路、向左链路的状态，然后 (r - 1, c) 离开前沿：
+ * 它所在的连通分量若不再出现在前沿中，就已经完整；此时若还有其他存活节点，
+ * 芯片必然有子图，该分支直接丢弃
+ */
+ReliabilityPolynomial::ReliabilityPolynomial(int N) : mesh_size_(N) {
+  if (N < 1 || N > kMaxWidth) {
+    throw std::invalid_argument("ReliabilityPolynomial supports 1 <= N <= 15");
+  }
+  const int V = num_vertices();
+  const int E = num_edges();
+  const size_t table_size = static_cast<size_t>(V + 1) * (E + 1);
+
+  Frontier start;
+  start.slots.assign(N, kDead);
+  std::unordered_map<uint64_t, std::vector<double>> layer;
+  layer[start.encode()] = std::vector<double>(table_size, 0.0);
+  layer.begin()->second[0] = 1.0;
+
+  CountTable table{E, 0, 0};
+  for (int v = 0; v < V; ++v) {
+    const int r = v / N;
+    const int c = v % N;
+    const bool has_up = r > 0;
+    const bool has_left = c > 0;
+
+    std::unordered_map<uint64_t, std::vector<double>> next;
+    auto emit = [&](Frontier f, const std::vector<double> &counts, int da,
+                    int dead_links, int free_links) {
+      f.canonicalize();
+      auto [it, inserted] = next.try_emplace(f.encode());
+      if (inserted) {
+        it->second.assign(table_size, 0.0);
+      }
+      table.add(it->second, counts, da, dead_links, free_links);
+    };
+
+    // 连通分量 label 离开前沿后的处理，返回 false 表示必然有子图
+    auto leave = [](Frontier &f, int label) {
+      if (label == kDead || f.contains(label)) {
+        return true;
+      }
+      if (f.closed || f.any_alive()) {
+        return false;
+      }
+      f.closed = true;
+      return true;
+    };
+
+    for (const auto &[key, counts] : layer) {
+      const Frontier f = Frontier::decode(key, N);
+      const int up = has_up ? f.slots[c] : kDead;
+      const int left = has_left ? f.slots[c - 1] : kDead;
+
+      // 新节点出错：相连链路的状态不影响连通性
+      {
+        Frontier g = f;
+        g.slots[c] = kDead;
+        if (leave(g, up)) {
+          emit(g, counts, 1, 0, int{has_up} + int{has_left});
+        }
+      }
+
+      // 新节点存活：已经有完整的连通分量时必然有子图
+      if (f.closed) {
+        continue;
+      }
+      // 存活端点之间的链路分为存在 / 出错两种情况，否则两种情况合并计数
+      const int up_choices = (up != kDead) ? 2 : 1;
+      const int left_choices = (left != kDead) ? 2 : 1;
+      for (int up_link = 0; up_link < up_choices; ++up_link) {
+        for (int left_link = 0; left_link < left_choices; ++left_link) {
+          Frontier g = f;
+          int dead_links = 0;
+          int free_links = 0;
+
+          if (up != kDead) {
+            if (up_link == 0) {
+              g.merge(up, kFresh);
+            } else {
+              ++dead_links;
+            }
+          } else if (has_up) {
+            ++free_links;
+          }
+
+          if (left != kDead) {
+            if (left_link == 0) {
+              g.merge(g.slots[c - 1], kFresh);
+            } else {
+              ++dead_links;
+            }
+          } else if (has_left) {
+            ++free_links;
+          }
+
+          int old_up = has_up ? g.slots[c] : kDead;
+          g.slots[c] = kFresh;
+          if (leave(g, old_up)) {
+            emit(g, counts, 0, dead_links, free_links);
+          }
+        }
+      }
+    }
+
+    layer = std::move(next);
+    table.max_a += 1;
+    table.max_b += int{has_up} + int{has_left};
+  }
+
+  // 最终状态：前沿中的连通分量加上已完整的分量至多一个
+  connected_counts_.assign(table_size, 0.0);
+  for (const auto &[key, counts] : layer) {
+    Frontier f = Frontier::decode(key, N);
+    std::vector<int> labels;
+    for (int label : f.slots) {
+      if (label != kDead && std::ranges::find(labels, label) == labels.end()) {
+        labels.push_back(label);
+      }
+    }
+    if (static_cast<int>(labels.size()) + int{f.closed} <= 1) {
+      for (size_t i = 0; i < table_size; ++i) {
+        connected_counts_[i] += counts[i];
+      }
+    }
+  }
+}
+
+double ReliabilityPolynomial::connected_count(int a, int b) const {
+  if (a < 0 || a > num_vertices() || b < 0 || b > num_edges()) {
+    return 0.0;
+  }
+  return connected_counts_[static_cast<size_t>(a) * (num_edges() + 1) + b];
+}
+
+/**
+ * @brief 按二项分布权重对计数表求和
+ * @param node_error_rate 节点错误率
+ * @param edge_error_rate 边错误率
+ * @param max_node_faults 参与求和的最大坏节点数
+ * @return 概率
+ */
+double ReliabilityPolynomial::evaluate(double node_error_rate,
+                                       double edge_error_rate,
+                                       int max_node_faults) const {
+  const int V = num_vertices();
+  const int E = num_edges();
+
+  // p^i (1 - p)^(n - i)
+  auto weights = [](int n, double p) {
+    std::vector<double> w(n + 1);
+    for (int i = 0; i <= n; ++i) {
+      w[i] = std::pow(p, i) * std::pow(1.0 - p, n - i);
+    }
+    return w;
+  };
+  std::vector<double> node_weights = weights(V, node_error_rate);
+  std::vector<double> edge_weights = weights(E, edge_error_rate);
+
+  double probability = 0.0;
+  for (int a = 0; a <= std::min(V, max_node_faults); ++a) {
+    const double *row = &connected_counts_[static_cast<size_t>(a) * (E + 1)];
+    double row_sum = 0.0;
+    for (int b = 0; b <= E; ++b) {
+      row_sum += row[b] * edge_weights[b];
+    }
+    probability += node_weights[a] * row_sum;
+  }
+  return probability;
+}
+
+double
+ReliabilityPolynomial::connected_probability(double node_error_rate,
+                                             double edge_error_rate) const {
+  return evaluate(node_error_rate, edge_error_rate, num_vertices());
+}
+
+double ReliabilityPolynomial::usable_probability(double node_error_rate,
+                                                 double edge_error_rate) const {
+  return evaluate(node_error_rate, edge_error_rate, 0);
+}
+
+/**
+ * @brief 给定错误率下的精确良率
+ * @param node_error_rate 节点错误率（0.0-1.0）
+ * @param edge_error_rate 边错误率（0.0-1.0）
+ * @return 良率（百分比）
+ *
+ * 芯片完整当且仅当没有任何节点和链路出错，不需要查表
+ */
+YieldEstimate ReliabilityPolynomial::estimate(float node_error_rate,
+                                              float edge_error_rate) const {
+  double full = std::pow(1.0 - node_error_rate, num_vertices()) *
+                std::pow(1.0 - edge_error_rate, num_edges());
+  YieldEstimate row{
+      mesh_size_, node_error_rate, edge_error_rate,
+      static_cast<float>(
+          (1.0 - connected_probability(node_error_rate, edge_error_rate)) *
+          100),
+      static_cast<float>((1.0 - full) * 100)};
+  row.usable_graphs_rate = static_cast<float>(
+      usable_probability(node_error_rate, edge_error_rate) * 100);
+  return row;
+}
+
+std::vector<YieldEstimate>
+ReliabilityPolynomial::sweep(const std::vector<float> &node_error_rates,
+                             const std::vector<float> &edge_error_rates) const {
+  std::vector<YieldEstimate> estimates;
+  estimates.reserve(node_error_rates.size() * edge_error_rates.size());
+  for (float node_rate : node_error_rates) {
+    for (float edge_rate : edge_error_rates) {
+      estimates.push_back(estimate(node_rate, edge_rate));
+    }
+  }
+  return estimates;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file reliability.h
+ * @brief 小网格的精确全端可靠度声明
+ *
+ * 按行优先顺序逐个节点扫描网格，用前沿（frontier）状态压缩记录连通关系，
+ * 一次构建出以节点/链路故障数为变量的可靠度多项式，之后任意错误率网格
+ * 都可以直接求值，没有抽样噪声
+ */
+
+#pragma once
+
+#include "yield_sweep.h"
+#include <vector>
+
+/**
+ * @brief 全端可靠度多项式
+ *
+ * connected_counts 第 (a, b) 项为：恰好 a 个节点、b 条链路出错，并且未删除
+ * 节点至多构成一个连通分量（即 has_subgraphs() 为 false）的故障组合数量。
+ * 每个节点、每条链路独立出错时：
+ *   P(连通) = sum_a sum_b C(a, b) pn^a (1 - pn)^(V - a) pe^b (1 - pe)^(E - b)
+ * a = 0 的一行就是“所有节点都存在且连通”的多项式。
+ *
+ * 状态数随网格宽度指数增长，k = 8 约需数十秒，适合 k <= 8；计数用 double 保存，
+ * 相对精度约为 1e-16
+ */
+class ReliabilityPolynomial {
+private:
+  int mesh_size_ = 0;
+  std::vector<double> connected_counts_; // 按 a * (E + 1) + b 存放
+
+  // 按二项分布权重求和，max_node_faults 限制 a 的范围
+  double evaluate(double node_error_rate, double edge_error_rate,
+                  int max_node_faults) const;
+
+public:
+  explicit ReliabilityPolynomial(int N);
+
+  int mesh_size() const { return mesh_size_; }
+  int num_vertices() const { return mesh_size_ * mesh_size_; }
+  int num_edges() const { return 2 * mesh_size_ * (mesh_size_ - 1); }
+
+  // 恰好 a 个节点、b 条链路出错且连通的故障组合数量
+  double connected_count(int a, int b) const;
+
+  // 未删除节点至多构成一个连通分量的概率（= 1 - P(has_subgraphs)）
+  double connected_probability(double node_error_rate,
+                               double edge_error_rate) const;
+
+  // 所有节点都存在且连通的概率
+  double usable_probability(double node_error_rate,
+                            double edge_error_rate) const;
+
+  // 给定错误率下的精确良率（百分比）
+  YieldEstimate estimate(float node_error_rate, float edge_error_rate) const;
+
+  // 整个错误率网格，顺序为 node_error_rate、edge_error_rate
+  std::vector<YieldEstimate>
+  sweep(const std::vector<float> &node_error_rates,
+        const std::vector<float> &edge_error_rates) const;
+};
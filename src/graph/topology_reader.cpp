@@ -0,0 +1,253 @@
+/**
+ * @file topology_reader.cpp
+ * @brief 拓扑结构文件读取实现
+ *
+ * 实现逐行扫描的解析器和按目录并行读取
+ */
+
+#include "topology_reader.h"
+#include "mesh.h"
+#include "mesh_layout.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+namespace {
+
+// 按节点编号推断时允许的最大网格大小
+constexpr int kMaxInferredMeshSize = 1024;
+
+/**
+ * @brief 解析时复用的缓冲区（每个线程一份）
+ */
+struct ParseScratch {
+  std::vector<std::pair<int, int>> links;
+  std::vector<int> dead_nodes;
+  std::vector<char> link_seen;
+  std::string file_content;
+};
+
+// 解析整段为非负整数，有多余字符时失败
+bool parse_int(std::string_view text, int &value) {
+  auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+  return ec == std::errc() && end == text.data() + text.size() && value >= 0;
+}
+
+// 解析 "<prefix><int>]"
+bool parse_attribute(std::string_view line, std::string_view prefix, int &value) {
+  if (!line.starts_with(prefix) || !line.ends_with(']')) {
+    return false;
+  }
+  line.remove_prefix(prefix.size());
+  line.remove_suffix(1);
+  return parse_int(line, value);
+}
+
+std::optional<ParsedTopology> parse_topology_impl(std::string_view text,
+                                                  int mesh_size,
+                                                  ParseScratch &scratch) {
+  ParsedTopology result;
+  scratch.links.clear();
+  scratch.dead_nodes.clear();
+
+  // 第 1..3 行是文件头，之后是链路和删除节点，以 "}" 结束
+  int line_no = 0;
+  int max_node = -1;
+  bool closed = false;
+  while (!text.empty()) {
+    size_t eol = text.find('\n');
+    std::string_view line = text.substr(0, eol);
+    text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+    if (line.ends_with('\r')) {
+      line.remove_suffix(1);
+    }
+    ++line_no;
+
+    if (closed) {
+      if (!line.empty()) {
+        LOG_ERROR("拓扑文件第 {} 行: '}}' 之后还有内容", line_no);
+        return std::nullopt;
+      }
+      continue;
+    }
+
+    bool ok = true;
+    if (line_no == 1) {
+      ok = line.starts_with("graph ") && line.ends_with(" {");
+      if (ok) {
+        result.name = line.substr(6, line.size() - 8);
+      }
+    } else if (line_no == 2) {
+      ok = parse_attribute(line, "\tedge[weight=", result.weight);
+    } else if (line_no == 3) {
+      ok = parse_attribute(line, "\tnode[pipeline_stage_delay=",
+                           result.pipeline_stage_delay);
+    } else if (line == "}") {
+      closed = true;
+    } else if (line.starts_with('\t')) {
+      line.remove_prefix(1);
+      size_t dash = line.find("--");
+      if (dash == std::string_view::npos) {
+        int node = 0;
+        ok = parse_int(line, node);
+        scratch.dead_nodes.push_back(node);
+        max_node = std::max(max_node, node);
+      } else {
+        int source_idx = 0;
+        int target_idx = 0;
+        ok = parse_int(line.substr(0, dash), source_idx) &&
+             parse_int(line.substr(dash + 2), target_idx);
+        scratch.links.emplace_back(source_idx, target_idx);
+        max_node = std::max({max_node, source_idx, target_idx});
+      }
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      LOG_ERROR("拓扑文件第 {} 行无法解析: '{}'", line_no, line);
+      return std::nullopt;
+    }
+  }
+  if (!closed) {
+    LOG_ERROR("拓扑文件缺少结尾的 '}'");
+    return std::nullopt;
+  }
+
+  // 推断尺寸时先限制范围，一行错误的大编号不能让后面的分配失控
+  int N = mesh_size;
+  if (N <= 0) {
+    int64_t inferred = static_cast<int64_t>(std::ceil(std::sqrt(
+        static_cast<double>(static_cast<int64_t>(max_node) + 1))));
+    if (inferred > kMaxInferredMeshSize) {
+      LOG_ERROR("拓扑文件 {} 的节点编号 {} 推断出的网格超过 {}x{}，"
+                "请显式指定网格大小",
+                result.name, max_node, kMaxInferredMeshSize,
+                kMaxInferredMeshSize);
+      return std::nullopt;
+    }
+    N = static_cast<int>(inferred);
+  }
+  if (N <= 0 || max_node >= static_cast<int64_t>(N) * N) {
+    LOG_ERROR("拓扑文件 {} 的节点编号 {} 超出 {}x{} 网格", result.name,
+              max_node, N, N);
+    return std::nullopt;
+  }
+
+  // 从完整网格出发：删除节点，再删除两端存活但没有出现的链路
+  const auto layout = mesh_layout(N);
+  result.bits = MeshBitset(N);
+  for (int node : scratch.dead_nodes) {
+    result.bits.delete_node(node);
+  }
+  scratch.link_seen.assign(layout->num_edges(), 0);
+  for (auto [source_idx, target_idx] : scratch.links) {
+    int edge = source_idx < target_idx ? layout->edge_id(source_idx, target_idx)
+                                       : -1;
+    if (edge < 0 || !result.bits.node_alive(source_idx) ||
+        !result.bits.node_alive(target_idx)) {
+      LOG_ERROR("拓扑文件 {} 中的链路 {}--{} 不是存活的网格相邻节点",
+                result.name, source_idx, target_idx);
+      return std::nullopt;
+    }
+    scratch.link_seen[edge] = 1;
+  }
+  for (int edge = 0; edge < layout->num_edges(); ++edge) {
+    if (!scratch.link_seen[edge]) {
+      auto [source_idx, target_idx] = layout->edge_endpoints[edge];
+      result.bits.delete_edge(source_idx, target_idx);
+    }
+  }
+  return result;
+}
+
+// 整个文件一次读入缓冲区
+bool read_file(const std::filesystem::path &file_path, std::string &content) {
+  std::ifstream infile(file_path, std::ios::binary);
+  if (!infile) {
+    LOG_ERROR("无法打开文件: {}", file_path.string());
+    return false;
+  }
+  infile.seekg(0, std::ios::end);
+  content.resize(static_cast<size_t>(infile.tellg()));
+  infile.seekg(0);
+  infile.read(content.data(), static_cast<std::streamsize>(content.size()));
+  return static_cast<bool>(infile);
+}
+
+std::optional<GraphWithMetadata> load_topology_impl(
+    const std::filesystem::path &file_path, int mesh_size,
+    ParseScratch &scratch) {
+  if (!read_file(file_path, scratch.file_content)) {
+    return std::nullopt;
+  }
+  auto parsed = parse_topology_impl(scratch.file_content, mesh_size, scratch);
+  if (!parsed) {
+    LOG_ERROR("无法解析拓扑文件: {}", file_path.string());
+    return std::nullopt;
+  }
+  int N = parsed->bits.size();
+  return GraphWithMetadata(std::move(parsed->bits), mesh_prototype(N));
+}
+
+} // namespace
+
+std::optional<ParsedTopology> parse_topology(std::string_view text,
+                                             int mesh_size) {
+  ParseScratch scratch;
+  return parse_topology_impl(text, mesh_size, scratch);
+}
+
+std::optional<GraphWithMetadata>
+load_topology(const std::filesystem::path &file_path, int mesh_size) {
+  ParseScratch scratch;
+  return load_topology_impl(file_path, mesh_size, scratch);
+}
+
+/**
+ * @brief 并行读取目录中的拓扑文件
+ * @param base_path 输出目录
+ * @param mesh_size 网格大小 N
+ * @return 按文件编号升序排列的芯片
+ *
+ * 只读取 graph_<编号>.gv，其他文件（如 multiplicity.csv）忽略。
+ * 每个线程复用自己的读缓冲区和解析缓冲区
+ */
+std::vector<GraphWithMetadata>
+load_topology_batch(const std::filesystem::path &base_path, int mesh_size) {
+  std::vector<std::pair<int, std::filesystem::path>> files;
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator(base_path, ec)) {
+    std::string stem = entry.path().stem().string();
+    int idx = 0;
+    if (entry.path().extension() == ".gv" && stem.starts_with("graph_") &&
+        parse_int(std::string_view(stem).substr(6), idx)) {
+      files.emplace_back(idx, entry.path());
+    }
+  }
+  if (ec) {
+    LOG_ERROR("无法读取目录: {}", base_path.string());
+    return {};
+  }
+  std::ranges::sort(files, {}, &std::pair<int, std::filesystem::path>::first);
+
+  std::vector<std::optional<GraphWithMetadata>> loaded(files.size());
+  tbb::enumerable_thread_specific<ParseScratch> scratches;
+  tbb::parallel_for(size_t{0}, files.size(), [&](size_t i) {
+    loaded[i] = load_topology_impl(files[i].second, mesh_size, scratches.local());
+  });
+
+  std::vector<GraphWithMetadata> graphs;
+  graphs.reserve(files.size());
+  for (auto &g : loaded) {
+    if (g) {
+      graphs.push_back(std::move(*g));
+    }
+  }
+  LOG_INFO("从 {} 读取了 {} 个拓扑文件（{} 个失败）", base_path.string(),
+           graphs.size(), files.size() - graphs.size());
+  return graphs;
+}
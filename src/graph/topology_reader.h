@@ -0,0 +1,63 @@
+/**
+ * @file topology_reader.h
+ * @brief 拓扑结构文件读取声明
+ *
+ * 解析 generate_topology 写出的 .gv 文件，重建位压缩后端的芯片。
+ * 只支持该函数输出的格式：
+ *   graph <name> {
+ *   \tedge[weight=<int>]
+ *   \tnode[pipeline_stage_delay=<int>]
+ *   \t<i>--<j>      存在的链路（i < j，且为网格相邻节点）
+ *   \t<i>           已删除的节点
+ *   }
+ * 没有出现在任何链路中、也没有被标为删除的节点视为存活的孤立节点
+ */
+
+#pragma once
+
+#include "mesh_data.h"
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 解析出的拓扑文件
+ */
+struct ParsedTopology {
+  std::string name;             // graph 名称
+  int weight = 1;               // 边权重
+  int pipeline_stage_delay = 1; // 流水线阶段延迟
+  MeshBitset bits;              // 芯片状态
+};
+
+/**
+ * @brief 解析一个拓扑文件的内容
+ * @param text 文件内容（只在内部按行切片，不复制）
+ * @param mesh_size 网格大小 N；为 0 时取能容纳最大节点编号的最小 N
+ *                  （编号最大的节点是存活孤立节点时推断会偏小，已知时应传入；
+ *                  推断结果超过 1024 时视为无法解析）
+ * @return 解析结果，格式不符时记录错误并返回 std::nullopt
+ */
+std::optional<ParsedTopology> parse_topology(std::string_view text,
+                                             int mesh_size = 0);
+
+/**
+ * @brief 读取一个拓扑文件
+ * @param file_path 文件路径
+ * @param mesh_size 网格大小 N（0 表示推断）
+ * @return 位压缩后端的芯片（共享网格原型），失败时返回 std::nullopt
+ */
+std::optional<GraphWithMetadata>
+load_topology(const std::filesystem::path &file_path, int mesh_size = 0);
+
+/**
+ * @brief 并行读取目录中的拓扑文件
+ * @param base_path generate_topology_batch 的输出目录
+ * @param mesh_size 网格大小 N（0 表示逐个文件推断）
+ * @return 按文件编号升序排列的芯片（graph_0.gv, graph_1.gv, ...），
+ *         无法解析的文件记录错误后跳过
+ */
+std::vector<GraphWithMetadata>
+load_topology_batch(const std::filesystem::path &base_path, int mesh_size = 0);
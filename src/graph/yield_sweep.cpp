@@ -0,0 +1,350 @@
+/**
+ * @file yield_sweep.cpp
+ * @brief 良率扫描引擎实现
+ *
+ * 实现格子/芯片块的任务划分、并行执行以及结果归并和 CSV 输出
+ */
+
+#include "yield_sweep.h"
+#include "Log.h"
+#include "error_inject.h"
+#include "mesh.h"
+#include "mesh_batch.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+namespace {
+
+/**
+ * @brief 扫描任务：一个格子中的一块芯片
+ */
+struct SweepTask {
+  int cell_idx;       // 格子索引
+  int64_t first_chip; // 块中第一个芯片在格子中的索引
+  int num_chips;      // 块中的芯片数量
+};
+
+/**
+ * @brief 单个任务的计数结果
+ */
+struct ChunkCounts {
+  int num_sub_graphs = 0;
+  int num_incomplete = 0;
+  int num_usable = 0;
+};
+
+// 估计比例为 p 时区间半宽达到目标所需的试验次数
+double required_trials(int successes, int trials, double z,
+                       double half_width) {
+  // 加 2 次命中、2 次未命中平滑，避免 p 为 0 或 1 时估计为 0
+  double p = (successes + 2.0) / (trials + 4.0);
+  return z * z * p * (1.0 - p) / (half_width * half_width);
+}
+
+} // namespace
+
+/**
+ * @brief Wilson 得分区间
+ * @param successes 命中次数
+ * @param trials 试验次数
+ * @param z 正态分位数
+ * @return 百分比形式的置信区间
+ *
+ * 比例接近 0 或 1 时仍然有合理的覆盖率，区间不会越过 [0, 100]
+ */
+RateInterval wilson_interval(int successes, int trials, double z) {
+  if (trials <= 0) {
+    return RateInterval{0.0f, 100.0f};
+  }
+  double n = trials;
+  double p = successes / n;
+  double z2 = z * z;
+  double denominator = 1.0 + z2 / n;
+  double center = (p + z2 / (2.0 * n)) / denominator;
+  double half = z * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) /
+                denominator;
+  return RateInterval{static_cast<float>(std::max(0.0, center - half) * 100),
+                      static_cast<float>(std::min(1.0, center + half) * 100)};
+}
+
+float YieldCell::sub_graphs_rate() const {
+  return num_samples == 0
+             ? 0.0f
+             : static_cast<float>(num_sub_graphs) / num_samples * 100;
+}
+
+float YieldCell::incomplete_graphs_rate() const {
+  return num_samples == 0
+             ? 0.0f
+             : static_cast<float>(num_incomplete) / num_samples * 100;
+}
+
+float YieldCell::usable_graphs_rate() const {
+  return num_samples == 0
+             ? 0.0f
+             : static_cast<float>(num_usable) / num_samples * 100;
+}
+
+double YieldCell::max_ci_half_width(double z) const {
+  double widest = 0.0;
+  for (int count : {num_sub_graphs, num_incomplete, num_usable}) {
+    RateInterval ci = wilson_interval(count, num_samples, z);
+    widest = std::max(widest, (ci.high - ci.low) / 200.0);
+  }
+  return widest;
+}
+
+YieldEstimate YieldCell::estimate(double z) const {
+  YieldEstimate row{mesh_size, node_error_rate, edge_error_rate,
+                    sub_graphs_rate(), incomplete_graphs_rate()};
+  row.usable_graphs_rate = usable_graphs_rate();
+  row.sub_graphs_ci = wilson_interval(num_sub_graphs, num_samples, z);
+  row.incomplete_graphs_ci = wilson_interval(num_incomplete, num_samples, z);
+  row.usable_graphs_ci = wilson_interval(num_usable, num_samples, z);
+  return row;
+}
+
+YieldSweep::YieldSweep(YieldSweepConfig config) : config_(std::move(config)) {
+  // 块大小取 64 的倍数，保证除最后一块外每个切片都是满的
+  int lanes = MeshBatch::kLanes;
+  config_.chunk_size =
+      std::max(lanes, (config_.chunk_size + lanes - 1) / lanes * lanes);
+}
+
+int YieldSweep::num_cells() const {
+  return static_cast<int>(config_.mesh_sizes.size() *
+                          config_.node_error_rates.size() *
+                          config_.edge_error_rates.size());
+}
+
+/**
+ * @brief 执行扫描
+ * @return 每个格子的统计结果
+ *
+ * 按轮执行：每一轮为每个未完成的格子安排若干块，并行执行后归并计数，
+ * 再判断哪些格子已经收敛。固定样本数时只有一轮。
+ * 同一格子的块在任务列表中相邻，工作线程连续拿到的任务通常网格大小相同，
+ * 临时批量只需 reset() 而不必重新分配
+ */
+std::vector<YieldCell> YieldSweep::run() const {
+  const auto &cfg = config_;
+  if (num_cells() == 0 || cfg.num_samples <= 0) {
+    return {};
+  }
+  const bool adaptive = cfg.ci_half_width > 0.0f;
+
+  // 按 mesh_size、node_error_rate、edge_error_rate 的顺序展开格子
+  std::vector<YieldCell> cells;
+  cells.reserve(num_cells());
+  for (int k : cfg.mesh_sizes) {
+    for (float node_rate : cfg.node_error_rates) {
+      for (float edge_rate : cfg.edge_error_rates) {
+        cells.push_back(YieldCell{k, node_rate, edge_rate});
+      }
+    }
+  }
+  std::vector<char> done(cells.size(), 0);
+
+  // 格子下一轮结束时应达到的芯片数量
+  auto next_target = [&](const YieldCell &cell) -> int64_t {
+    if (!adaptive) {
+      return cfg.num_samples;
+    }
+    if (cell.num_samples == 0) {
+      return std::min(cfg.chunk_size, cfg.num_samples);
+    }
+    double needed = 0.0;
+    for (int count : {cell.num_sub_graphs, cell.num_incomplete,
+                      cell.num_usable}) {
+      needed = std::max(needed, required_trials(count, cell.num_samples,
+                                                cfg.confidence_z,
+                                                cfg.ci_half_width));
+    }
+    // 每轮最多增长到 4 倍，防止早期估计偏差导致过度抽样
+    int64_t target = std::min<int64_t>(static_cast<int64_t>(std::ceil(needed)),
+                                       4LL * cell.num_samples);
+    target = std::max<int64_t>(target, cell.num_samples + cfg.chunk_size);
+    return std::min<int64_t>(target, cfg.num_samples);
+  };
+
+  tbb::enumerable_thread_specific<MeshBatch> scratch;
+  tbb::task_arena arena(cfg.num_threads > 0 ? cfg.num_threads
+                                            : tbb::task_arena::automatic);
+  std::vector<SweepTask> tasks;
+  std::vector<ChunkCounts> counts;
+
+  for (;;) {
+    // 只为尚未完成的格子切块
+    tasks.clear();
+    for (int c = 0; c < static_cast<int>(cells.size()); ++c) {
+      if (done[c]) {
+        continue;
+      }
+      int64_t target = next_target(cells[c]);
+      for (int64_t first = cells[c].num_samples; first < target;
+           first += cfg.chunk_size) {
+        int chips = static_cast<int>(
+            std::min<int64_t>(cfg.chunk_size, target - first));
+        tasks.push_back(SweepTask{c, first, chips});
+      }
+    }
+    if (tasks.empty()) {
+      break;
+    }
+
+    // 每个任务写自己的槽位，不需要加锁
+    counts.assign(tasks.size(), ChunkCounts{});
+    auto run_task = [&](size_t t) {
+      const SweepTask &task = tasks[t];
+      const YieldCell &cell = cells[task.cell_idx];
+
+      MeshBatch &batch = scratch.local();
+      if (batch.size() != cell.mesh_size ||
+          batch.num_chips() != task.num_chips) {
+        batch = MeshBatch(cell.mesh_size, task.num_chips);
+      } else {
+        batch.reset();
+      }
+
+      // 每个芯片使用自己的计数器随机流，结果与线程数和块大小无关
+      random_error_inject(batch, cell.node_error_rate, cell.edge_error_rate,
+                          cfg.seed, task.cell_idx, task.first_chip);
+
+      std::vector<char> sub_graphs = batch.has_subgraphs();
+      std::vector<char> full = batch.is_full();
+      std::vector<char> connected = batch.is_connected();
+      std::vector<char> all_nodes = batch.is_all_nodes_exist();
+      ChunkCounts &out = counts[t];
+      for (int c = 0; c < task.num_chips; ++c) {
+        out.num_sub_graphs += sub_graphs[c];
+        out.num_incomplete += !full[c];
+        out.num_usable += connected[c] && all_nodes[c];
+      }
+    };
+
+    arena.execute([&] {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, tasks.size(), 1),
+                        [&](const tbb::blocked_range<size_t> &range) {
+                          for (size_t t = range.begin(); t != range.end();
+                               ++t) {
+                            run_task(t);
+                          }
+                        });
+    });
+
+    // 按格子归并
+    for (size_t t = 0; t < tasks.size(); ++t) {
+      YieldCell &cell = cells[tasks[t].cell_idx];
+      cell.num_samples += tasks[t].num_chips;
+      cell.num_sub_graphs += counts[t].num_sub_graphs;
+      cell.num_incomplete += counts[t].num_incomplete;
+      cell.num_usable += counts[t].num_usable;
+    }
+
+    // 判断收敛
+    for (size_t c = 0; c < cells.size(); ++c) {
+      done[c] = !adaptive || cells[c].num_samples >= cfg.num_samples ||
+                cells[c].max_ci_half_width(cfg.confidence_z) <=
+                    cfg.ci_half_width;
+    }
+  }
+  return cells;
+}
+
+/**
+ * @brief 重新生成单个芯片
+ * @param cell_idx 格子索引（与 run() 结果的下标一致）
+ * @param chip_idx 芯片在格子中的索引
+ * @return 与 run() 中该芯片故障完全相同的图
+ */
+GraphWithMetadata YieldSweep::replay_chip(int cell_idx, int64_t chip_idx) const {
+  const auto &cfg = config_;
+  int edge_count = static_cast<int>(cfg.edge_error_rates.size());
+  int node_count = static_cast<int>(cfg.node_error_rates.size());
+
+  int k = cfg.mesh_sizes[cell_idx / (node_count * edge_count)];
+  float node_rate = cfg.node_error_rates[cell_idx / edge_count % node_count];
+  float edge_rate = cfg.edge_error_rates[cell_idx % edge_count];
+
+  GraphWithMetadata g = generate_mesh_bitset(k);
+  chip_error_inject(g, node_rate, edge_rate, cfg.seed, cell_idx, chip_idx);
+  return g;
+}
+
+/**
+ * @brief 把良率估计写成热力图 CSV
+ * @param estimates 良率估计
+ * @param out_dir 输出目录
+ *
+ * 列格式与 scripts/plot_heatmap.py 读取的格式一致，错误率和比例都是百分比
+ */
+void write_heatmap_csv(const std::vector<YieldEstimate> &estimates,
+                       const std::filesystem::path &out_dir) {
+  std::filesystem::create_directories(out_dir);
+
+  std::vector<int> sizes;
+  for (const auto &row : estimates) {
+    if (std::ranges::find(sizes, row.mesh_size) == sizes.end()) {
+      sizes.push_back(row.mesh_size);
+    }
+  }
+
+  for (int k : sizes) {
+    auto filename = out_dir / ("heatmap_data_k" + std::to_string(k) + ".csv");
+    std::ofstream outfile(filename);
+    if (!outfile.is_open()) {
+      LOG_INFO("无法打开文件: {}", filename.string());
+      continue;
+    }
+
+    // 所有行都有置信区间时才写附加列
+    bool with_ci = std::ranges::all_of(estimates, [k](const auto &row) {
+      return row.mesh_size != k ||
+             (row.usable_graphs_rate && row.sub_graphs_ci &&
+              row.incomplete_graphs_ci && row.usable_graphs_ci);
+    });
+
+    outfile << "node_error_rate,edge_error_rate,sub_graphs_rate,"
+               "incomplete_graphs_rate";
+    if (with_ci) {
+      outfile << ",usable_graphs_rate,sub_graphs_rate_ci_low,"
+                 "sub_graphs_rate_ci_high,incomplete_graphs_rate_ci_low,"
+                 "incomplete_graphs_rate_ci_high,usable_graphs_rate_ci_low,"
+                 "usable_graphs_rate_ci_high";
+    }
+    outfile << "\n";
+    for (const auto &row : estimates) {
+      if (row.mesh_size != k) {
+        continue;
+      }
+      outfile << row.node_error_rate * 100 << "," << row.edge_error_rate * 100
+              << "," << row.sub_graphs_rate << ","
+              << row.incomplete_graphs_rate;
+      if (with_ci) {
+        outfile << "," << *row.usable_graphs_rate << ","
+                << row.sub_graphs_ci->low << "," << row.sub_graphs_ci->high
+                << "," << row.incomplete_graphs_ci->low << ","
+                << row.incomplete_graphs_ci->high << ","
+                << row.usable_graphs_ci->low << ","
+                << row.usable_graphs_ci->high;
+      }
+      outfile << "\n";
+    }
+    LOG_INFO("数据已保存到文件: {}", filename.string());
+  }
+}
+
+// 把扫描结果写成热力图 CSV，附带置信区间列
+void write_heatmap_csv(const std::vector<YieldCell> &cells,
+                       const std::filesystem::path &out_dir, double z) {
+  write_heatmap_csv(cells | std::views::transform([z](const YieldCell &cell) {
+                      return cell.estimate(z);
+                    }) | std::ranges::to<std::vector>(),
+                    out_dir);
+}
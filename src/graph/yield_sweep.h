@@ -0,0 +1,141 @@
+/**
+ * @file yield_sweep.h
+ * @brief 良率扫描引擎声明
+ *
+ * 在 (网格大小, 节点错误率, 边错误率) 网格上批量注入故障并统计良率，
+ * 用于生成热力图数据
+ */
+
+#pragma once
+
+#include "mesh_data.h"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief 良率扫描配置
+ *
+ * 每个 (mesh_size, node_error_rate, edge_error_rate) 组合是一个格子。
+ * ci_half_width 为 0 时每个格子抽样 num_samples 个芯片；大于 0 时按块逐轮抽样，
+ * 格子中所有统计比例的 Wilson 区间半宽都不超过目标后停止，
+ * 此时 num_samples 是每个格子的上限
+ */
+struct YieldSweepConfig {
+  std::vector<int> mesh_sizes;          // 网格大小 k（k x k）
+  std::vector<float> node_error_rates;  // 节点错误率（0.0-1.0）
+  std::vector<float> edge_error_rates;  // 边错误率（0.0-1.0）
+  int num_samples = 10000;              // 每个格子的芯片数量
+  int chunk_size = 1024;                // 每个任务的芯片数量（取 64 的倍数）
+  uint64_t seed = 42;                   // 随机种子，结果只由种子决定
+  int num_threads = 0;                  // 工作线程数，0 表示使用全部核心
+  float ci_half_width = 0.0f;           // 目标置信区间半宽（比例），0 表示不自适应
+  double confidence_z = 1.96;           // 置信水平对应的正态分位数（95%）
+};
+
+/**
+ * @brief 比例的置信区间（百分比）
+ */
+struct RateInterval {
+  float low = 0.0f;
+  float high = 0.0f;
+};
+
+/**
+ * @brief Wilson 得分区间
+ * @param successes 命中次数
+ * @param trials 试验次数
+ * @param z 正态分位数
+ * @return 百分比形式的置信区间，trials 为 0 时为 [0, 100]
+ */
+RateInterval wilson_interval(int successes, int trials, double z);
+
+/**
+ * @brief 单个格子的良率估计（百分比），热力图 CSV 的一行
+ */
+struct YieldEstimate {
+  int mesh_size = 0;
+  float node_error_rate = 0.0f;
+  float edge_error_rate = 0.0f;
+  float sub_graphs_rate = 0.0f;        // 有子图的芯片比例（%）
+  float incomplete_graphs_rate = 0.0f; // 不完整的芯片比例（%）
+
+  // 以下为可选字段：抽样扫描给出全部字段，可靠性多项式只给出精确的
+  // usable_graphs_rate（没有置信区间）；全部存在时写 CSV 才作为附加列
+  std::optional<float> usable_graphs_rate; // 所有节点存在且连通的比例（%）
+  std::optional<RateInterval> sub_graphs_ci;
+  std::optional<RateInterval> incomplete_graphs_ci;
+  std::optional<RateInterval> usable_graphs_ci;
+};
+
+/**
+ * @brief 单个格子的统计结果
+ */
+struct YieldCell {
+  int mesh_size = 0;
+  float node_error_rate = 0.0f;
+  float edge_error_rate = 0.0f;
+  int num_samples = 0;    // 抽样芯片数量
+  int num_sub_graphs = 0; // 有子图（连通分量多于 1 个）的芯片数量
+  int num_incomplete = 0; // 不完整（缺少链路）的芯片数量
+  int num_usable = 0;     // 所有节点存在且只有一个连通分量的芯片数量
+
+  // 百分比形式的比例，与热力图 CSV 一致
+  float sub_graphs_rate() const;
+  float incomplete_graphs_rate() const;
+  float usable_graphs_rate() const;
+
+  // 所有统计比例中最宽的 Wilson 区间半宽（比例）
+  double max_ci_half_width(double z) const;
+
+  // 转换为 CSV 行，附带 z 对应的置信区间
+  YieldEstimate estimate(double z = 1.96) const;
+};
+
+/**
+ * @brief 良率扫描引擎
+ *
+ * 把每个格子切成若干芯片块，所有块作为独立任务交给 TBB 的工作窃取调度器。
+ * 每个工作线程复用自己的 MeshBatch 临时批量，每个块的结果写入独立的槽位，
+ * 扫描结束后再按格子归并，整个过程不需要全局锁。
+ * 每个芯片的故障来自 chip_fault_rng(seed, k, 格子, 芯片)，
+ * 因此结果与线程数、块大小无关，任何一个芯片都可以单独重放。
+ * 自适应模式下每一轮只为尚未收敛的格子安排任务，并按当前估计的比例
+ * 预估还需要的芯片数量，计算量集中到比例接近 50% 的格子上
+ */
+class YieldSweep {
+private:
+  YieldSweepConfig config_;
+
+public:
+  explicit YieldSweep(YieldSweepConfig config);
+
+  const YieldSweepConfig &config() const { return config_; }
+
+  // 格子数量
+  int num_cells() const;
+
+  // 执行扫描，结果按 mesh_size、node_error_rate、edge_error_rate 的顺序排列
+  std::vector<YieldCell> run() const;
+
+  // 单独重新生成某个格子中的某个芯片（不执行整个扫描）
+  GraphWithMetadata replay_chip(int cell_idx, int64_t chip_idx) const;
+};
+
+/**
+ * @brief 把良率估计写成热力图 CSV
+ * @param estimates 良率估计
+ * @param out_dir 输出目录，每个网格大小写一个 heatmap_data_k{k}.csv
+ */
+void write_heatmap_csv(const std::vector<YieldEstimate> &estimates,
+                       const std::filesystem::path &out_dir);
+
+/**
+ * @brief 把扫描结果写成热力图 CSV
+ * @param cells 扫描结果
+ * @param out_dir 输出目录，每个网格大小写一个 heatmap_data_k{k}.csv
+ * @param z 置信区间列使用的正态分位数
+ */
+void write_heatmap_csv(const std::vector<YieldCell> &cells,
+                       const std::filesystem::path &out_dir, double z = 1.96);
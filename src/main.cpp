@@ -6,23 +6,94 @@
  */
 
 #include "Log.h"
+#include "chip_pipeline.h"
+#include "conditional_yield.h"
 #include "error_inject.h"
+#include "fault_enum.h"
 #include "mesh.h"
 #include "mesh_data.h"
 #include "mesh_utils.h"
+#include "reliability.h"
 #include "traffic.h"
 #include "traffic_formatter.h"
 #include "utils.h"
+#include "yield_sweep.h"
 #include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <numeric>
-#include <omp.h>
 #include <random>
 #include <string>
 
 static std::mt19937 g_rng(42);
 
+/**
+ * @brief 生成良率热力图数据
+ * @param out_dir 输出目录
+ *
+ * k = 2..8，节点错误率 0.5%-10%，边错误率 1%-10%。
+ * 每个 k 只构建一次条件良率表，整个错误率网格由二项分布混合得到
+ */
+void run_yield_heatmap(const std::filesystem::path &out_dir) {
+  std::vector<float> node_error_rates;
+  for (int j_idx = 0; j_idx <= 19; ++j_idx) {
+    node_error_rates.push_back(0.005f + j_idx * 0.005f);
+  }
+  std::vector<float> edge_error_rates;
+  for (int i_idx = 0; i_idx <= 18; ++i_idx) {
+    edge_error_rates.push_back(0.01f + i_idx * 0.005f);
+  }
+
+  ScopedTimer timer("yield heatmap");
+  std::vector<YieldEstimate> estimates;
+  for (int k = 2; k <= 8; ++k) {
+    // 小网格直接用精确的可靠度多项式，没有抽样噪声
+    if (k <= 6) {
+      std::ranges::copy(
+          ReliabilityPolynomial(k).sweep(node_error_rates, edge_error_rates),
+          std::back_inserter(estimates));
+      continue;
+    }
+    ConditionalYieldConfig config;
+    config.mesh_size = k;
+    config.max_node_error_rate = node_error_rates.back();
+    config.max_edge_error_rate = edge_error_rates.back();
+    ConditionalYieldTable table(config);
+    std::ranges::copy(table.sweep(node_error_rates, edge_error_rates),
+                      std::back_inserter(estimates));
+  }
+  write_heatmap_csv(estimates, out_dir);
+}
+
+/**
+ * @brief 流式抽样并输出最好的芯片拓扑
+ * @param out_dir 输出目录
+ *
+ * 芯片逐个生成、注入、过滤，只保留分数最高的 top_k 个，
+ * 内存与抽样数量无关
+ */
+void run_chip_stream(const std::filesystem::path &out_dir) {
+  ChipStreamConfig config;
+  config.mesh_size = 4;
+  config.num_chips = 100'000'000;
+  config.edge_error_rate = 0.2f;
+  config.delete_isolated_nodes = true;
+  const size_t top_k = 1000;
+
+  ScopedTimer timer("chip stream");
+  TopKByScore top(top_k);
+  auto usable = chip_stream(config) |
+                std::views::filter([](const GraphWithMetadata &g) {
+                  return g.is_all_nodes_exist() && g.num_components() == 1;
+                });
+  for (GraphWithMetadata &&g : usable) {
+    top.push(std::move(g));
+  }
+  LOG_INFO("{} 个芯片中 {} 个可用，保留 {} 个", config.num_chips,
+           top.num_pushed(), top.size());
+  generate_topology_stream(top.take_sorted(), out_dir);
+}
+
 /**
  * @brief 程序主函数
  * @return 程序退出码
@@ -34,15 +105,22 @@ int main() {
 
   ScopedTimer timer("start the program");
 
-  std::vector<GraphWithMetadata> graphs =
-      generate_mesh_graph_manual_batch(300, 4);
+  // 穷举 4x4 网格删除 leave_edge_count 条链路的全部情况；
+  // 旋转 / 翻转等价的拓扑在输出前统一去重，以保留每类的芯片数量
+  std::vector<GraphWithMetadata> graphs;
+  FaultEnumConfig enum_config;
+  enum_config.mesh_size = 4;
+  enum_config.num_edge_faults = leave_edge_count;
+  enum_config.use_symmetry = false;
+  FaultEnumStats enum_stats = enumerate_fault_patterns(
+      enum_config, [&](const FaultPattern &, const MeshBitset &bits, int) {
+        graphs.emplace_back(bits, mesh_prototype(enum_config.mesh_size));
+      });
+  LOG_INFO("故障组合 {} 种", enum_stats.num_patterns);
 
   // 注入节点错误
   //   random_error_inject(graphs, 0.01, 0.05, g_rng);
 
-  std::ranges::for_each(graphs, [&](GraphWithMetadata &g) {
-    g.remove_random_edges(leave_edge_count);
-  });
   // 删除孤立节点
   std::ranges::for_each(
       graphs, [](GraphWithMetadata &g) { g.delete_isolated_nodes(); });
@@ -58,7 +136,14 @@ int main() {
   std::string base_path =
       "/home/shimingyu/Proj/Fenyin/out/graph/nodes_exist_4_4_edge_" +
       std::to_string(leave_edge_count) + "/";
-  generate_topology_batch(selected_graph, base_path, 1, 1);
+  std::vector<SymmetryGroup> groups = dedup_by_symmetry(selected_graph);
+  generate_topology_batch(selected_graph, groups, base_path, 1, 1);
+
+  // 流式抽样（可选，取消注释以启用）
+  // run_chip_stream("out/graph/stream");
+
+  // 良率热力图（可选，取消注释以启用）
+  // run_yield_heatmap("out");
 
   // auto out = random_traffic_generate(g_rng, graphs[4800], 1, "BF16", 32);
 
@@ -67,72 +152,3 @@ int main() {
   // // std::println("{}", ss);
   return 0;
 }
-
-//  // 创建输出文件夹
-//   std::filesystem::create_directories("out");
-
-//   for (int k = 2; k <= 8; k++) {
-//     // 为每个 k 创建对应的 CSV 文件
-//     std::string filename = "out/heatmap_data_k" + std::to_string(k) + ".csv";
-//     std::ofstream outfile(filename);
-//     if (!outfile.is_open()) {
-//       LOG_INFO("无法打开文件: {}", filename);
-//       continue;
-//     }
-//     LOG_INFO("output file: {}", filename);
-
-//     // 写入 CSV 表头
-//     outfile << "node_error_rate,edge_error_rate,sub_graphs_rate,"
-//                "incomplete_graphs_rate\n";
-// #pragma omp parallel for collapse(2) schedule(dynamic)
-//     for (int j_idx = 0; j_idx <= 19; ++j_idx) {
-//       for (int i_idx = 0; i_idx <= 18; ++i_idx) {
-
-//         float j = 0.005f + j_idx * 0.005f;
-//         float i = 0.01f + i_idx * 0.005f;
-//         std::mt19937 local_rng(std::random_device{}());
-
-//         std::vector<GraphWithMetadata> graphs =
-//             generate_mesh_graph_manual_batch(10000, k);
-
-//         random_error_inject(graphs, j, i, local_rng);
-
-//         // std::ranges::for_each(
-//         //     graphs, [](GraphWithMetadata &g) { g.delete_isolated_nodes();
-//         }); auto sub_graphs = graphs |
-//         std::views::filter([](GraphWithMetadata &g) {
-//                             return g.has_subgraphs();
-//                           });
-//         auto incomplete_graphs =
-//             graphs | std::views::filter(
-//                          [](GraphWithMetadata &g) { return !g.is_full(); });
-
-//         float sub_graphs_rate =
-//             static_cast<float>(std::ranges::distance(sub_graphs)) / 10000 *
-//             100;
-//         float incomplete_graphs_rate =
-//             static_cast<float>(std::ranges::distance(incomplete_graphs)) /
-//             10000 * 100;
-
-// #pragma omp critical
-//         {
-//           LOG_INFO("start with topology size: {} and node error rate: {:.2f}%
-//           "
-//                    "and edge error rate: {:.2f}%",
-//                    k, j * 100, i * 100);
-//           LOG_INFO("sub_graphs rate: {:.4f}%", sub_graphs_rate);
-//           LOG_INFO("incomplete_graphs rate: {:.4f}%",
-//           incomplete_graphs_rate);
-//           LOG_INFO("--------------------------------");
-
-//           outfile << j * 100 << "," << i * 100 << "," << sub_graphs_rate <<
-//           ","
-//                   << incomplete_graphs_rate << "\n";
-//           outfile.flush();
-//         }
-//       }
-//     }
-
-//     outfile.close();
-//     LOG_INFO("数据已保存到文件: {}", filename);
-//   }
\ No newline at end of file
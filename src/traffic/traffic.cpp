@@ -6,10 +6,13 @@
  */
 
 #include "traffic.h"
+#include "traffic_table.h"
 #include <algorithm>
+#include <charconv>
 #include <format>
+#include <ostream>
 #include <string>
-#include <unordered_map>
+#include <tbb/parallel_for.h>
 
 /**
  * @brief 从向量中随机选择一个元素
@@ -68,169 +71,222 @@ std::pair<std::string, int> random_gemm_generate(const int numbers,
 }
 
 /**
- * @brief 生成单轮随机流量节点
+ * @brief 生成多轮随机流量
  * @param rng 随机数生成器
  * @param graph 图结构
  * @param layer_num 每个节点的GEMM层数
  * @param data_type 数据类型
- * @return 流量节点向量
- *
- * 生成流程：
- * 1. 获取所有有效节点ID
- * 2. 为每个节点随机生成发送流量和目标节点
- * 3. 建立接收关系
- * 4. 对接收流量排序并确定发送顺序
+ * @param round_num 轮数
+ * @return 多轮流量节点
  */
-std::vector<TrafficNode>
-_random_traffic_generate(std::mt19937 &rng, GraphWithMetadata &graph,
-                         int layer_num, const std::string &data_type) {
-  std::vector<TrafficNode> traffic_nodes;
-
-  // 获取所有有效节点ID
-  std::vector<int> node_ids;
-  auto vertices = boost::vertices(graph.graph());
-  for (const auto &v : std::ranges::subrange(vertices.first, vertices.second)) {
-    if (!graph.graph()[v].is_deleted) {
-      node_ids.push_back(graph.graph()[v].id);
-    }
-  }
-
-  if (node_ids.size() < 2) {
-    return traffic_nodes; // 节点数少于2，无法建立流量关系
-  }
-
-  // 为每个节点生成发送流量（随机选择目标节点）
-  for (auto node_id : node_ids) {
-    auto [ss, total_size] = random_gemm_generate(layer_num, rng, data_type);
-
-    // 在 node_ids 里除当前节点以外随机选一个作为目标
-    std::vector<int> candidates;
-    for (const auto &id : node_ids) {
-      if (id != node_id) {
-        candidates.push_back(id);
-      }
-    }
-    std::uniform_int_distribution<> dist(
-        0, static_cast<int>(candidates.size()) - 1);
-    int target_node = candidates[dist(rng)];
-
-    traffic_nodes.emplace_back(node_id, ss,
-                               std::make_pair(target_node, total_size));
-  }
-
-  // 建立接收关系：为每个节点创建ID到TrafficNode的映射
-  std::unordered_map<int, std::vector<TrafficNode>::iterator> node_map;
-  for (auto it = traffic_nodes.begin(); it != traffic_nodes.end(); ++it) {
-    node_map[it->id] = it;
-  }
-
-  // 将发送信息添加到目标节点的接收列表中
-  for (auto &traffic_node : traffic_nodes) {
-    int source_node = traffic_node.id;
-    int target_node = traffic_node.send_traffic.first;
-    int data_size = traffic_node.send_traffic.second;
-
-    auto target_it = node_map.find(target_node);
-    if (target_it != node_map.end()) {
-      target_it->second->recv_traffic.emplace_back(source_node, data_size);
-    }
-  }
-
-  // 对接收流量排序并确定发送顺序
-  for (auto &traffic_node : traffic_nodes) {
-    if (!traffic_node.recv_traffic.empty()) {
-      // 按发送方ID从大到小排序（大编号节点先发送）
-      std::ranges::sort(
-          traffic_node.recv_traffic,
-          [](const auto &a, const auto &b) { return a.first > b.first; });
-
-      // 如果最大发送方ID >= 当前节点ID，需要先接收后发送
-      int max_sender_id = traffic_node.recv_traffic.front().first;
-      traffic_node.is_send_first = (max_sender_id < traffic_node.id);
-    }
+std::vector<std::vector<TrafficNode>>
+random_traffic_generate(std::mt19937 &rng, const GraphWithMetadata &graph,
+                        int layer_num, const std::string &data_type,
+                        const int round_num) {
+  const DataType type = parse_data_type(data_type);
+  std::vector<std::vector<TrafficNode>> traffic_nodes;
+  traffic_nodes.reserve(round_num);
+  for (int i = 0; i < round_num; i++) {
+    traffic_nodes.push_back(
+        to_traffic_nodes(random_traffic_round(rng, graph, layer_num, type)));
   }
-
   return traffic_nodes;
 }
 
+Philox4x32 traffic_rng(uint64_t seed, int64_t graph_idx, int round_idx) {
+  // 与 chip_fault_rng 使用不同的密钥，同一个种子下两类随机流也不重叠
+  uint64_t key = splitmix64(seed ^ splitmix64(0x7472616666696300ULL));
+  uint64_t graph = static_cast<uint64_t>(graph_idx);
+  return Philox4x32(key, static_cast<uint32_t>(round_idx),
+                    static_cast<uint32_t>(graph),
+                    static_cast<uint32_t>(graph >> 32));
+}
+
 /**
- * @brief 生成多轮随机流量
- * @param rng 随机数生成器
+ * @brief 并行生成多轮可复现的随机流量
+ * @param seed 随机种子
  * @param graph 图结构
  * @param layer_num 每个节点的GEMM层数
  * @param data_type 数据类型
  * @param round_num 轮数
+ * @param graph_idx 图的索引（区分随机流）
  * @return 多轮流量节点
+ *
+ * 第 r 轮只使用 traffic_rng(seed, graph_idx, r)，结果与线程数无关
  */
 std::vector<std::vector<TrafficNode>>
-random_traffic_generate(std::mt19937 &rng, GraphWithMetadata &graph,
+random_traffic_generate(uint64_t seed, const GraphWithMetadata &graph,
                         int layer_num, const std::string &data_type,
-                        const int round_num) {
-  std::vector<std::vector<TrafficNode>> traffic_nodes;
-  for (int i = 0; i < round_num; i++) {
-    traffic_nodes.push_back(
-        _random_traffic_generate(rng, graph, layer_num, data_type));
-  }
+                        const int round_num, int64_t graph_idx) {
+  const DataType type = parse_data_type(data_type);
+  std::vector<std::vector<TrafficNode>> traffic_nodes(round_num);
+  tbb::parallel_for(0, round_num, [&](int round_idx) {
+    Philox4x32 rng = traffic_rng(seed, graph_idx, round_idx);
+    traffic_nodes[round_idx] =
+        to_traffic_nodes(random_traffic_round(rng, graph, layer_num, type));
+  });
   return traffic_nodes;
 }
 
 /**
- * @brief 将单轮流量节点转换为C++代码字符串
+ * @brief 为一批图并行生成多轮随机流量
+ * @param seed 随机种子
+ * @param graphs 图向量
+ * @param layer_num 每个节点的GEMM层数
+ * @param data_type 数据类型
+ * @param round_num 每个图的轮数
+ * @return 每个图的多轮流量节点
+ *
+ * 图和轮展开成一个并行区间，第 g 个图与单独调用
+ * random_traffic_generate(seed, graphs[g], ..., g) 的结果相同
+ */
+std::vector<std::vector<std::vector<TrafficNode>>>
+random_traffic_generate_batch(uint64_t seed,
+                              const std::vector<GraphWithMetadata> &graphs,
+                              int layer_num, const std::string &data_type,
+                              const int round_num) {
+  const DataType type = parse_data_type(data_type);
+  std::vector<std::vector<std::vector<TrafficNode>>> traffic_nodes(
+      graphs.size(), std::vector<std::vector<TrafficNode>>(round_num));
+  const size_t total = graphs.size() * static_cast<size_t>(round_num);
+  tbb::parallel_for(size_t{0}, total, [&](size_t idx) {
+    size_t graph_idx = idx / round_num;
+    int round_idx = static_cast<int>(idx % round_num);
+    Philox4x32 rng =
+        traffic_rng(seed, static_cast<int64_t>(graph_idx), round_idx);
+    traffic_nodes[graph_idx][round_idx] = to_traffic_nodes(
+        random_traffic_round(rng, graphs[graph_idx], layer_num, type));
+  });
+  return traffic_nodes;
+}
+
+namespace {
+
+// 追加十进制整数
+void append_int(std::string &out, int value) {
+  char buffer[16];
+  auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.append(buffer, end);
+}
+
+// 追加 ,"<op>","<id>","<size>"
+void append_op(std::string &out, std::string_view op, int id, int size) {
+  out += ",\"";
+  out += op;
+  out += "\",\"";
+  append_int(out, id);
+  out += "\",\"";
+  append_int(out, size);
+  out += '"';
+}
+
+/**
+ * @brief 将单轮流量节点追加为C++代码
+ * @param out 输出缓冲区
  * @param traffic_nodes 流量节点向量
- * @return C++代码字符串，格式为逗号分隔的字段列表
  *
  * 输出格式：
  * - 先发送模式：layers, "send", target_id, size, "recv", sender_id, size, ...
  * - 先接收模式：layers, "recv", sender_id, size, ..., "send", target_id, size,
  * "recv", sender_id, size, ...
  */
-std::string _traffic_gen_to_cpp_code(std::vector<TrafficNode> traffic_nodes) {
-  std::string ss;
+void _traffic_gen_to_cpp_code(std::string &out,
+                              const std::vector<TrafficNode> &traffic_nodes) {
   for (auto [index, traffic_node] :
        std::ranges::enumerate_view(traffic_nodes)) {
-    if (index == 0) {
-      ss += std::format("{}", traffic_node.layers);
-    } else {
-      ss += std::format(",{}", traffic_node.layers);
+    if (index != 0) {
+      out += ',';
     }
+    out += traffic_node.layers;
 
     if (traffic_node.is_send_first) {
       // 先发送后接收模式
-      ss += std::format(",\"send\",\"{}\",\"{}\"",
-                        traffic_node.send_traffic.first,
-                        traffic_node.send_traffic.second);
-
+      append_op(out, "send", traffic_node.send_traffic.first,
+                traffic_node.send_traffic.second);
       for (const auto &recv_traffic : traffic_node.recv_traffic) {
-        ss += std::format(",\"recv\",\"{}\",\"{}\"", recv_traffic.first,
-                          recv_traffic.second);
+        append_op(out, "recv", recv_traffic.first, recv_traffic.second);
       }
     } else {
       // 先接收后发送模式：send混在recv中间
       // 先接收发送方ID >= 当前节点ID的流量
       for (const auto &recv_traffic : traffic_node.recv_traffic) {
         if (recv_traffic.first >= traffic_node.id) {
-          ss += std::format(",\"recv\",\"{}\",\"{}\"", recv_traffic.first,
-                            recv_traffic.second);
+          append_op(out, "recv", recv_traffic.first, recv_traffic.second);
         }
       }
 
       // 发送自己的流量
-      ss += std::format(",\"send\",\"{}\",\"{}\"",
-                        traffic_node.send_traffic.first,
-                        traffic_node.send_traffic.second);
+      append_op(out, "send", traffic_node.send_traffic.first,
+                traffic_node.send_traffic.second);
 
       // 最后接收发送方ID < 当前节点ID的流量
       for (const auto &recv_traffic : traffic_node.recv_traffic) {
         if (recv_traffic.first < traffic_node.id) {
-          ss += std::format(",\"recv\",\"{}\",\"{}\"", recv_traffic.first,
-                            recv_traffic.second);
+          append_op(out, "recv", recv_traffic.first, recv_traffic.second);
         }
       }
     }
   }
-  return ss;
 }
 
+/**
+ * @brief 将紧凑表示的单轮流量追加为C++代码
+ * @param out 输出缓冲区
+ * @param round 单轮流量
+ *
+ * 输出与 to_traffic_nodes 后再转换相同：接收列表按发送方ID从大到小，
+ * 发送方ID >= 当前节点ID 的在 send 之前，其余在之后
+ */
+void _traffic_gen_to_cpp_code(std::string &out, const TrafficRound &round) {
+  for (size_t i = 0; i < round.num_nodes(); ++i) {
+    if (i != 0) {
+      out += ',';
+    }
+    auto layers = round.node_layers(i);
+    for (size_t layer = 0; layer < layers.size(); ++layer) {
+      out += layer == 0 ? "\"" : ",\"";
+      out += gemm_shape_name(layers[layer]);
+      out += '"';
+    }
+
+    const int self = round.node_ids[i];
+    auto sources = round.recv_sources(i);
+    auto split = std::ranges::find_if(
+        sources, [&](int source) { return round.node_ids[source] < self; });
+    for (int source : std::ranges::subrange(sources.begin(), split)) {
+      append_op(out, "recv", round.node_ids[source], round.send_size[source]);
+    }
+    append_op(out, "send", round.node_ids[round.send_target[i]],
+              round.send_size[i]);
+    for (int source : std::ranges::subrange(split, sources.end())) {
+      append_op(out, "recv", round.node_ids[source], round.send_size[source]);
+    }
+  }
+}
+
+/**
+ * @brief 逐轮输出C++代码
+ * @param rounds 多轮流量（TrafficNode 向量或 TrafficRound）
+ * @param emit 接收每一段输出（std::string_view）
+ *
+ * 每轮在复用的缓冲区中生成后交给 emit，峰值内存只与单轮大小有关
+ */
+template <typename Rounds, typename Emit>
+void emit_cpp_code(const Rounds &rounds, Emit &&emit) {
+  std::string chunk = "{\n";
+  for (auto [index, round] : std::ranges::enumerate_view(rounds)) {
+    chunk += index == 0 ? " { " : ",\n{ ";
+    _traffic_gen_to_cpp_code(chunk, round);
+    chunk += " }";
+    emit(std::string_view(chunk));
+    chunk.clear();
+  }
+  chunk += "\n};";
+  emit(std::string_view(chunk));
+}
+
+} // namespace
+
 /**
  * @brief 将多轮流量节点转换为C++代码字符串
  * @param traffic_nodes 多轮流量节点
@@ -244,21 +300,40 @@ std::string _traffic_gen_to_cpp_code(std::vector<TrafficNode> traffic_nodes) {
  * };
  */
 std::string
-traffic_gen_to_cpp_code(std::vector<std::vector<TrafficNode>> traffic_nodes) {
+traffic_gen_to_cpp_code(const std::vector<std::vector<TrafficNode>> &traffic_nodes) {
   std::string ss;
-  ss += "{\n";
-  for (auto [index, traffic_node] :
-       std::ranges::enumerate_view(traffic_nodes)) {
-    if (index == 0) {
-      ss += std::format(" {{ {} }}", _traffic_gen_to_cpp_code(traffic_node));
-    } else {
-      ss += std::format(",\n{{ {} }}", _traffic_gen_to_cpp_code(traffic_node));
-    }
-  }
-  ss += "\n};";
+  emit_cpp_code(traffic_nodes, [&](std::string_view chunk) { ss += chunk; });
   return ss;
 }
 
+/**
+ * @brief 将多轮流量节点逐轮写出为C++代码
+ * @param out 输出流
+ * @param traffic_nodes 多轮流量节点
+ *
+ * 与 traffic_gen_to_cpp_code 的输出相同，但不生成完整字符串
+ */
+void write_traffic_cpp_code(
+    std::ostream &out,
+    const std::vector<std::vector<TrafficNode>> &traffic_nodes) {
+  emit_cpp_code(traffic_nodes, [&](std::string_view chunk) {
+    out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+  });
+}
+
+std::string traffic_gen_to_cpp_code(const std::vector<TrafficRound> &rounds) {
+  std::string ss;
+  emit_cpp_code(rounds, [&](std::string_view chunk) { ss += chunk; });
+  return ss;
+}
+
+void write_traffic_cpp_code(std::ostream &out,
+                            const std::vector<TrafficRound> &rounds) {
+  emit_cpp_code(rounds, [&](std::string_view chunk) {
+    out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+  });
+}
+
 // 使用示例
 //  auto out = random_traffic_generate(g_rng, graphs[0], 2, "BF16", 4);
 
@@ -7,19 +7,59 @@
 
 #pragma once
 
+#include <cstdint>
+#include <ostream>
 #include <print>
 #include <random>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "mesh_data.h"
+#include "philox.h"
+
+/**
+ * @brief GEMM 数据类型
+ */
+enum class DataType : uint8_t { FP32, FP16, BF16, INT8, UINT8, INT32, FP64 };
+
+/**
+ * @brief 数据类型的字节大小
+ */
+constexpr int data_type_size(DataType type) {
+  switch (type) {
+  case DataType::FP16:
+  case DataType::BF16:
+    return 2;
+  case DataType::INT8:
+  case DataType::UINT8:
+    return 1;
+  case DataType::FP64:
+    return 8;
+  case DataType::FP32:
+  case DataType::INT32:
+    break;
+  }
+  return 4;
+}
+
+/// 数据类型名称（"FLOAT" 即 FP32），TYPE_SIZE_MAP 和 parse_data_type 都由此得到
+constexpr std::pair<std::string_view, DataType> DATA_TYPE_NAMES[] = {
+    {"FP32", DataType::FP32},   {"FLOAT", DataType::FP32},
+    {"FP16", DataType::FP16},   {"BF16", DataType::BF16},
+    {"INT8", DataType::INT8},   {"UINT8", DataType::UINT8},
+    {"INT32", DataType::INT32}, {"FP64", DataType::FP64}};
 
 /// 数据类型到字节大小的映射表
-const std::unordered_map<std::string, size_t> TYPE_SIZE_MAP = {
-    {"FP32", 4}, {"FLOAT", 4}, {"FP16", 2},  {"BF16", 2},
-    {"INT8", 1}, {"UINT8", 1}, {"INT32", 4}, {"FP64", 8}};
+const std::unordered_map<std::string, size_t> TYPE_SIZE_MAP = [] {
+  std::unordered_map<std::string, size_t> map;
+  for (auto [name, type] : DATA_TYPE_NAMES) {
+    map.emplace(name, data_type_size(type));
+  }
+  return map;
+}();
 
 /// ScaleSim 仿真中 GEMM 操作的 M 维度可选值
 const std::vector<int> M_VALUES = {16};
@@ -83,14 +123,64 @@ std::pair<std::string, int> random_gemm_generate(const int numbers,
  * @return 多轮流量节点，每轮是一个 TrafficNode 向量
  */
 std::vector<std::vector<TrafficNode>>
-random_traffic_generate(std::mt19937 &rng, GraphWithMetadata &graph,
+random_traffic_generate(std::mt19937 &rng, const GraphWithMetadata &graph,
                         int layer_num, const std::string &data_type,
                         const int round_num);
 
+/**
+ * @brief 获取单轮流量的随机流
+ * @param seed 随机种子
+ * @param graph_idx 图的索引
+ * @param round_idx 轮的索引
+ * @return 只由这三个参数决定的计数器随机数生成器
+ */
+Philox4x32 traffic_rng(uint64_t seed, int64_t graph_idx, int round_idx);
+
+/**
+ * @brief 并行生成多轮可复现的随机流量
+ * @param seed 随机种子
+ * @param graph 图结构
+ * @param layer_num 每个节点的GEMM层数
+ * @param data_type 数据类型
+ * @param round_num 轮数
+ * @param graph_idx 图的索引（区分不同图的随机流）
+ * @return 多轮流量节点，第 r 轮使用 traffic_rng(seed, graph_idx, r)
+ */
+std::vector<std::vector<TrafficNode>>
+random_traffic_generate(uint64_t seed, const GraphWithMetadata &graph,
+                        int layer_num, const std::string &data_type,
+                        const int round_num, int64_t graph_idx = 0);
+
+/**
+ * @brief 为一批图并行生成多轮随机流量
+ * @param seed 随机种子
+ * @param graphs 图向量
+ * @param layer_num 每个节点的GEMM层数
+ * @param data_type 数据类型
+ * @param round_num 每个图的轮数
+ * @return 每个图的多轮流量节点，第 g 个图使用 graph_idx = g 的随机流
+ */
+std::vector<std::vector<std::vector<TrafficNode>>>
+random_traffic_generate_batch(uint64_t seed,
+                              const std::vector<GraphWithMetadata> &graphs,
+                              int layer_num, const std::string &data_type,
+                              const int round_num);
+
 /**
  * @brief 将多轮流量节点转换为C++代码字符串
  * @param traffic_nodes 多轮流量节点
  * @return C++代码字符串，格式为嵌套的初始化列表
  */
 std::string
-traffic_gen_to_cpp_code(std::vector<std::vector<TrafficNode>> traffic_nodes);
\ No newline at end of file
+traffic_gen_to_cpp_code(const std::vector<std::vector<TrafficNode>> &traffic_nodes);
+
+/**
+ * @brief 将多轮流量节点逐轮写出为C++代码
+ * @param out 输出流（文件、字符串流，或 boost::iostreams 的压缩流）
+ * @param traffic_nodes 多轮流量节点
+ *
+ * 输出与 traffic_gen_to_cpp_code 相同，每轮生成后立即写出
+ */
+void write_traffic_cpp_code(
+    std::ostream &out,
+    const std::vector<std::vector<TrafficNode>> &traffic_nodes);
\ No newline at end of file
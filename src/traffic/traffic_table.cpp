@@ -0,0 +1,209 @@
+/**
+ * @file traffic_table.cpp
+ * @brief 紧凑的流量表示实现
+ *
+ * 实现形状表、单轮流量生成和到 TrafficNode 的转换
+ */
+
+#include "traffic_table.h"
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <tbb/parallel_for.h>
+
+namespace {
+
+/**
+ * @brief 形状表及其名称（只构建一次）
+ */
+struct GemmShapeTable {
+  std::vector<GemmShape> shapes;
+  std::vector<std::string> names;
+
+  GemmShapeTable() {
+    // 形状编号存为 GemmShapeId，组合数不能超过其取值范围
+    const size_t count = M_VALUES.size() * N_VALUES.size() * K_VALUES.size();
+    if (count > size_t{std::numeric_limits<GemmShapeId>::max()} + 1) {
+      throw std::runtime_error(std::format(
+          "GEMM 形状组合数 {} 超出 GemmShapeId 的范围", count));
+    }
+    shapes.reserve(count);
+    names.reserve(count);
+    for (int m : M_VALUES) {
+      for (int n : N_VALUES) {
+        for (int k : K_VALUES) {
+          shapes.push_back({m, n, k});
+          names.push_back(std::format("gemm_{}_{}_{}", m, n, k));
+        }
+      }
+    }
+  }
+};
+
+const GemmShapeTable &gemm_shape_table() {
+  static const GemmShapeTable table;
+  return table;
+}
+
+// 与 random_selecte 消耗相同的随机数，返回下标
+template <typename Rng> int random_index(size_t size, Rng &rng) {
+  std::uniform_int_distribution<> dist(0, static_cast<int>(size) - 1);
+  return dist(rng);
+}
+
+/**
+ * @brief 生成单轮随机流量
+ * @param rng 随机数生成器
+ * @param graph 图结构
+ * @param layer_num 每个节点的GEMM层数
+ * @param data_type 数据类型
+ * @return 单轮流量
+ *
+ * 每个节点先抽 layer_num 个形状（每个形状依次抽 m、n、k），再抽目标：
+ * 在除自身以外的 n - 1 个节点中抽下标。接收关系按发送方从大到小
+ * 计数排序到 CSR 数组中，整轮 O(V)
+ */
+template <typename Rng>
+TrafficRound generate_round(Rng &rng, const GraphWithMetadata &graph,
+                            int layer_num, DataType data_type) {
+  const auto &table = gemm_shape_table();
+  const int type_size = data_type_size(data_type);
+
+  TrafficRound round;
+  round.data_type = data_type;
+  round.layer_num = layer_num;
+
+  const int V = graph.num_vertices();
+  for (int i = 0; i < V; ++i) {
+    if (graph.node_alive(i)) {
+      round.node_ids.push_back(i);
+    }
+  }
+  const int n = static_cast<int>(round.node_ids.size());
+  if (n < 2) {
+    round.node_ids.clear();
+    round.recv_offsets.assign(1, 0);
+    return round; // 节点数少于2，无法建立流量关系
+  }
+
+  round.layers.reserve(static_cast<size_t>(n) * layer_num);
+  round.send_target.reserve(n);
+  round.send_size.reserve(n);
+  std::uniform_int_distribution<> dist(0, n - 2);
+  for (int self = 0; self < n; ++self) {
+    int total_size = 0;
+    for (int layer = 0; layer < layer_num; ++layer) {
+      int mi = random_index(M_VALUES.size(), rng);
+      int ni = random_index(N_VALUES.size(), rng);
+      int ki = random_index(K_VALUES.size(), rng);
+      auto id = static_cast<GemmShapeId>(
+          (mi * N_VALUES.size() + ni) * K_VALUES.size() + ki);
+      const GemmShape &shape = table.shapes[id];
+      round.layers.push_back(id);
+      total_size += type_size * (shape.m * shape.n);
+    }
+    int pick = dist(rng);
+    round.send_target.push_back(pick < self ? pick : pick + 1);
+    round.send_size.push_back(total_size);
+  }
+
+  // CSR：先统计每个节点的发送方数量，再按发送方从大到小填入
+  round.recv_offsets.assign(n + 1, 0);
+  for (int target : round.send_target) {
+    ++round.recv_offsets[target + 1];
+  }
+  for (int i = 0; i < n; ++i) {
+    round.recv_offsets[i + 1] += round.recv_offsets[i];
+  }
+  round.recv_source.resize(n);
+  std::vector<uint32_t> cursor(round.recv_offsets.begin(),
+                               round.recv_offsets.end() - 1);
+  for (int source = n - 1; source >= 0; --source) {
+    round.recv_source[cursor[round.send_target[source]]++] = source;
+  }
+  return round;
+}
+
+} // namespace
+
+DataType parse_data_type(std::string_view name) {
+  auto it = std::ranges::find(DATA_TYPE_NAMES, name,
+                              &std::pair<std::string_view, DataType>::first);
+  if (it == std::end(DATA_TYPE_NAMES)) {
+    throw std::invalid_argument(std::format("未知的数据类型: {}", name));
+  }
+  return it->second;
+}
+
+const std::vector<GemmShape> &gemm_shapes() {
+  return gemm_shape_table().shapes;
+}
+
+const std::string &gemm_shape_name(GemmShapeId id) {
+  return gemm_shape_table().names[id];
+}
+
+size_t TrafficRound::memory_bytes() const {
+  return node_ids.size() * sizeof(int) + layers.size() * sizeof(GemmShapeId) +
+         send_target.size() * sizeof(int) + send_size.size() * sizeof(int) +
+         recv_offsets.size() * sizeof(uint32_t) +
+         recv_source.size() * sizeof(int);
+}
+
+TrafficRound random_traffic_round(std::mt19937 &rng,
+                                  const GraphWithMetadata &graph,
+                                  int layer_num, DataType data_type) {
+  return generate_round(rng, graph, layer_num, data_type);
+}
+
+TrafficRound random_traffic_round(Philox4x32 &rng,
+                                  const GraphWithMetadata &graph,
+                                  int layer_num, DataType data_type) {
+  return generate_round(rng, graph, layer_num, data_type);
+}
+
+std::vector<TrafficRound>
+random_traffic_table(uint64_t seed, const GraphWithMetadata &graph,
+                     int layer_num, DataType data_type, const int round_num,
+                     int64_t graph_idx) {
+  std::vector<TrafficRound> rounds(round_num);
+  tbb::parallel_for(0, round_num, [&](int round_idx) {
+    Philox4x32 rng = traffic_rng(seed, graph_idx, round_idx);
+    rounds[round_idx] = generate_round(rng, graph, layer_num, data_type);
+  });
+  return rounds;
+}
+
+/**
+ * @brief 转换为 TrafficNode 形式
+ * @param round 单轮流量
+ * @return 流量节点向量
+ *
+ * layers 字符串为逗号分隔、带引号的形状名称，与 random_gemm_generate 一致
+ */
+std::vector<TrafficNode> to_traffic_nodes(const TrafficRound &round) {
+  std::vector<TrafficNode> traffic_nodes;
+  traffic_nodes.reserve(round.num_nodes());
+  for (size_t i = 0; i < round.num_nodes(); ++i) {
+    std::string layers;
+    for (GemmShapeId id : round.node_layers(i)) {
+      if (!layers.empty()) {
+        layers += ',';
+      }
+      layers += '"';
+      layers += gemm_shape_name(id);
+      layers += '"';
+    }
+    TrafficNode &node = traffic_nodes.emplace_back(
+        round.node_ids[i], std::move(layers),
+        std::make_pair(round.node_ids[round.send_target[i]],
+                       round.send_size[i]));
+    for (int source : round.recv_sources(i)) {
+      node.recv_traffic.emplace_back(round.node_ids[source],
+                                     round.send_size[source]);
+    }
+    node.is_send_first = round.is_send_first(i);
+  }
+  return traffic_nodes;
+}
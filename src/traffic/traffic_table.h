@@ -0,0 +1,151 @@
+/**
+ * @file traffic_table.h
+ * @brief 紧凑的流量表示定义
+ *
+ * 每轮流量按列存储：GEMM 层存为形状编号，数据类型为枚举，
+ * 接收关系为 CSR 数组，只有输出时才生成字符串。
+ * TrafficNode 形式可以由 to_traffic_nodes 转换得到
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mesh_data.h"
+#include "philox.h"
+#include "traffic.h"
+
+/**
+ * @brief 解析数据类型名称（DATA_TYPE_NAMES 中的名称）
+ * @param name 数据类型名称
+ * @return 数据类型，未知名称时抛出 std::invalid_argument
+ */
+DataType parse_data_type(std::string_view name);
+
+/**
+ * @brief GEMM 形状
+ */
+struct GemmShape {
+  int m;
+  int n;
+  int k;
+};
+
+/// GEMM 形状编号
+using GemmShapeId = uint16_t;
+
+/**
+ * @brief 所有可选的 GEMM 形状
+ * @return M_VALUES × N_VALUES × K_VALUES 的全部组合，
+ *         按 (m, n, k) 的下标编号：id = (mi * |N| + ni) * |K| + ki
+ *
+ * 组合数超过 GemmShapeId 的取值范围时抛出 std::runtime_error
+ */
+const std::vector<GemmShape> &gemm_shapes();
+
+/**
+ * @brief GEMM 形状的名称
+ * @param id 形状编号
+ * @return "gemm_m_n_k"（预先生成，不分配）
+ */
+const std::string &gemm_shape_name(GemmShapeId id);
+
+/**
+ * @brief 单轮流量（结构体数组）
+ *
+ * 节点按ID升序排列，下标 i 对应 node_ids[i]；
+ * 目标和发送方都存为下标，数据量由发送方的 send_size 给出
+ */
+struct TrafficRound {
+  DataType data_type = DataType::BF16;
+  int layer_num = 0;
+
+  std::vector<int> node_ids;          // 存活节点ID（升序）
+  std::vector<GemmShapeId> layers;    // 第 i 个节点的层为 [i * layer_num, (i + 1) * layer_num)
+  std::vector<int> send_target;       // 目标节点下标
+  std::vector<int> send_size;         // 发送数据量（字节）
+  std::vector<uint32_t> recv_offsets; // 第 i 个节点的发送方为 recv_source[recv_offsets[i] .. recv_offsets[i + 1])
+  std::vector<int> recv_source;       // 发送方下标，按节点ID从大到小
+
+  size_t num_nodes() const { return node_ids.size(); }
+
+  std::span<const GemmShapeId> node_layers(size_t i) const {
+    return std::span(layers).subspan(i * layer_num, layer_num);
+  }
+
+  std::span<const int> recv_sources(size_t i) const {
+    return std::span(recv_source)
+        .subspan(recv_offsets[i], recv_offsets[i + 1] - recv_offsets[i]);
+  }
+
+  // 是否先发送后接收：没有发送方ID >= 当前节点ID 时先发送
+  bool is_send_first(size_t i) const {
+    return recv_offsets[i] == recv_offsets[i + 1] ||
+           node_ids[recv_source[recv_offsets[i]]] < node_ids[i];
+  }
+
+  // 各数组占用的字节数
+  size_t memory_bytes() const;
+};
+
+/**
+ * @brief 生成单轮随机流量
+ * @param rng 随机数生成器
+ * @param graph 图结构
+ * @param layer_num 每个节点的GEMM层数
+ * @param data_type 数据类型
+ * @return 单轮流量，节点数少于 2 时为空
+ *
+ * 随机数的消耗顺序与 random_traffic_generate 相同，
+ * 同一个随机流得到的 to_traffic_nodes 结果与其一致
+ */
+TrafficRound random_traffic_round(std::mt19937 &rng,
+                                  const GraphWithMetadata &graph,
+                                  int layer_num, DataType data_type);
+TrafficRound random_traffic_round(Philox4x32 &rng,
+                                  const GraphWithMetadata &graph,
+                                  int layer_num, DataType data_type);
+
+/**
+ * @brief 并行生成多轮可复现的随机流量
+ * @param seed 随机种子
+ * @param graph 图结构
+ * @param layer_num 每个节点的GEMM层数
+ * @param data_type 数据类型
+ * @param round_num 轮数
+ * @param graph_idx 图的索引（区分不同图的随机流）
+ * @return 多轮流量，第 r 轮使用 traffic_rng(seed, graph_idx, r)
+ */
+std::vector<TrafficRound>
+random_traffic_table(uint64_t seed, const GraphWithMetadata &graph,
+                     int layer_num, DataType data_type, const int round_num,
+                     int64_t graph_idx = 0);
+
+/**
+ * @brief 转换为 TrafficNode 形式
+ * @param round 单轮流量
+ * @return 流量节点向量（按节点ID升序）
+ */
+std::vector<TrafficNode> to_traffic_nodes(const TrafficRound &round);
+
+/**
+ * @brief 将多轮紧凑流量转换为C++代码字符串
+ * @param rounds 多轮流量
+ * @return 与 traffic_gen_to_cpp_code(to_traffic_nodes 的结果) 相同，
+ *         不经过 TrafficNode
+ */
+std::string traffic_gen_to_cpp_code(const std::vector<TrafficRound> &rounds);
+
+/**
+ * @brief 将多轮紧凑流量逐轮写出为C++代码
+ * @param out 输出流
+ * @param rounds 多轮流量
+ */
+void write_traffic_cpp_code(std::ostream &out,
+                            const std::vector<TrafficRound> &rounds);
@@ -0,0 +1,213 @@
+/**
+ * @file traffic_trace.cpp
+ * @brief 二进制流量轨迹格式实现
+ *
+ * 实现轨迹的逐轮写出和读取
+ */
+
+#include "traffic_trace.h"
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kTraceMagic[8] = {'F', 'Y', 'T', 'R', 'A', 'C', 'E', '\0'};
+constexpr uint32_t kTraceVersion = 1;
+
+/**
+ * @brief 每轮记录的头部
+ */
+struct RoundHeader {
+  uint32_t num_nodes;
+  uint16_t layer_num;
+  uint8_t data_type;
+  uint8_t reserved;
+};
+static_assert(sizeof(RoundHeader) == 8);
+
+template <typename T> void write_pod(std::ostream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+void write_array(std::ostream &out, const std::vector<T> &values) {
+  out.write(reinterpret_cast<const char *>(values.data()),
+            static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template <typename T> void read_pod(std::istream &in, T &value) {
+  if (!in.read(reinterpret_cast<char *>(&value), sizeof(T))) {
+    throw std::runtime_error("流量轨迹不完整");
+  }
+}
+
+/**
+ * @brief 读取 count 个元素
+ *
+ * count 来自文件，不能直接按它分配：按块扩容，
+ * 截断或损坏的文件在读到结尾时失败，占用的内存不超过实际读到的数据
+ */
+template <typename T>
+void read_array(std::istream &in, std::vector<T> &values, size_t count) {
+  constexpr size_t kChunk = size_t{1} << 16;
+  values.clear();
+  while (values.size() < count) {
+    const size_t pos = values.size();
+    const size_t len = std::min(kChunk, count - pos);
+    values.resize(pos + len);
+    if (!in.read(reinterpret_cast<char *>(values.data() + pos),
+                 static_cast<std::streamsize>(len * sizeof(T)))) {
+      throw std::runtime_error("流量轨迹不完整");
+    }
+  }
+}
+
+// 所有值都在 [0, bound) 内
+template <typename T>
+bool all_below(const std::vector<T> &values, size_t bound) {
+  return std::ranges::all_of(values, [bound](T value) {
+    return value >= 0 && static_cast<size_t>(value) < bound;
+  });
+}
+
+/**
+ * @brief 校验读入的一轮
+ * @param round 单轮流量
+ * @param index 轮次（用于错误信息）
+ *
+ * 保证之后按下标访问不会越界：节点ID为升序的非负整数，
+ * 层编号在形状表内，目标和发送方都是节点下标
+ */
+void validate_round(const TrafficRound &round, size_t index) {
+  const size_t n = round.num_nodes();
+  const bool ids_sorted = std::ranges::adjacent_find(
+                              round.node_ids, std::greater_equal<>()) ==
+                          round.node_ids.end();
+  if (!ids_sorted || (n > 0 && round.node_ids.front() < 0)) {
+    throw std::runtime_error(
+        std::format("流量轨迹第 {} 轮的节点ID不是升序的非负整数", index));
+  }
+  if (!all_below(round.layers, gemm_shapes().size())) {
+    throw std::runtime_error(
+        std::format("流量轨迹第 {} 轮的 GEMM 形状编号超出形状表", index));
+  }
+  if (!all_below(round.send_target, n) || !all_below(round.recv_source, n)) {
+    throw std::runtime_error(
+        std::format("流量轨迹第 {} 轮的发送目标或发送方超出节点范围", index));
+  }
+}
+
+// recv_offsets 从 0 开始单调不减且不超过 n，读 recv_source 之前校验
+void validate_recv_offsets(const TrafficRound &round, size_t index) {
+  const auto &offsets = round.recv_offsets;
+  if (offsets.front() != 0 || !std::ranges::is_sorted(offsets) ||
+      offsets.back() > round.num_nodes()) {
+    throw std::runtime_error(
+        std::format("流量轨迹第 {} 轮的接收偏移不正确", index));
+  }
+}
+
+} // namespace
+
+TrafficTraceWriter::TrafficTraceWriter(std::ostream &out) : out_(out) {
+  const auto &shapes = gemm_shapes();
+  out_.write(kTraceMagic, sizeof(kTraceMagic));
+  write_pod(out_, kTraceVersion);
+  write_pod(out_, static_cast<uint32_t>(shapes.size()));
+  for (const auto &shape : shapes) {
+    write_pod(out_, static_cast<int32_t>(shape.m));
+    write_pod(out_, static_cast<int32_t>(shape.n));
+    write_pod(out_, static_cast<int32_t>(shape.k));
+  }
+}
+
+void TrafficTraceWriter::write(const TrafficRound &round) {
+  // 读取时按节点数推算各数组长度，长度不一致的轮写出后无法读回
+  const size_t n = round.num_nodes();
+  if (round.layers.size() != n * round.layer_num ||
+      round.send_target.size() != n || round.send_size.size() != n ||
+      round.recv_offsets.size() != n + 1 ||
+      round.recv_source.size() != round.recv_offsets.back()) {
+    throw std::invalid_argument(std::format(
+        "第 {} 轮流量的数组长度与节点数 {} 不一致", num_rounds_, n));
+  }
+  RoundHeader header{static_cast<uint32_t>(round.num_nodes()),
+                     static_cast<uint16_t>(round.layer_num),
+                     static_cast<uint8_t>(round.data_type), 0};
+  write_pod(out_, header);
+  write_array(out_, round.node_ids);
+  write_array(out_, round.layers);
+  write_array(out_, round.send_target);
+  write_array(out_, round.send_size);
+  write_array(out_, round.recv_offsets);
+  write_array(out_, round.recv_source);
+  ++num_rounds_;
+}
+
+void write_traffic_trace(std::ostream &out,
+                         const std::vector<TrafficRound> &rounds) {
+  TrafficTraceWriter writer(out);
+  for (const auto &round : rounds) {
+    writer.write(round);
+  }
+}
+
+std::vector<TrafficRound> read_traffic_trace(std::istream &in) {
+  char magic[sizeof(kTraceMagic)];
+  uint32_t version = 0;
+  uint32_t num_shapes = 0;
+  if (!in.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kTraceMagic, sizeof(kTraceMagic)) != 0) {
+    throw std::runtime_error("不是流量轨迹文件");
+  }
+  read_pod(in, version);
+  if (version != kTraceVersion) {
+    throw std::runtime_error("不支持的流量轨迹版本");
+  }
+
+  // 形状编号只在形状表相同时才有意义
+  read_pod(in, num_shapes);
+  const auto &shapes = gemm_shapes();
+  bool same_shapes = num_shapes == shapes.size();
+  for (uint32_t i = 0; i < num_shapes; ++i) {
+    int32_t m = 0;
+    int32_t n = 0;
+    int32_t k = 0;
+    read_pod(in, m);
+    read_pod(in, n);
+    read_pod(in, k);
+    same_shapes = same_shapes && shapes[i].m == m && shapes[i].n == n &&
+                  shapes[i].k == k;
+  }
+  if (!same_shapes) {
+    throw std::runtime_error("流量轨迹的 GEMM 形状表与当前配置不一致");
+  }
+
+  std::vector<TrafficRound> rounds;
+  RoundHeader header{};
+  while (in.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    if (header.data_type > static_cast<uint8_t>(DataType::FP64)) {
+      throw std::runtime_error(std::format("流量轨迹第 {} 轮的数据类型 {} 未知",
+                                           rounds.size(), header.data_type));
+    }
+    TrafficRound &round = rounds.emplace_back();
+    const size_t n = header.num_nodes;
+    round.layer_num = header.layer_num;
+    round.data_type = static_cast<DataType>(header.data_type);
+    read_array(in, round.node_ids, n);
+    read_array(in, round.layers, n * round.layer_num);
+    read_array(in, round.send_target, n);
+    read_array(in, round.send_size, n);
+    read_array(in, round.recv_offsets, n + 1);
+    validate_recv_offsets(round, rounds.size() - 1);
+    read_array(in, round.recv_source, round.recv_offsets.back());
+    validate_round(round, rounds.size() - 1);
+  }
+  if (in.gcount() != 0) {
+    throw std::runtime_error("流量轨迹不完整");
+  }
+  return rounds;
+}
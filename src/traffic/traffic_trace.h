@@ -0,0 +1,63 @@
+/**
+ * @file traffic_trace.h
+ * @brief 二进制流量轨迹格式声明
+ *
+ * 供下游仿真器直接读取的紧凑格式，逐轮写出，可以接在任何 std::ostream
+ * 之后（文件、内存缓冲区、boost::iostreams 的压缩流）。
+ *
+ * 格式（小端）：
+ *   文件头：magic "FYTRACE\0"、uint32 版本、uint32 形状数量 S，
+ *           然后是 S 个形状（int32 m, n, k），形状编号即下标
+ *   每轮：uint32 节点数 n、uint16 层数 L、uint8 数据类型、uint8 保留，
+ *         然后依次为 node_ids int32[n]、layers uint16[n * L]、
+ *         send_target int32[n]、send_size int32[n]、
+ *         recv_offsets uint32[n + 1]、recv_source int32[recv_offsets[n]]
+ *   轮记录一直到文件结束，目标和发送方均为节点下标（见 TrafficRound）
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "traffic_table.h"
+
+/**
+ * @brief 二进制流量轨迹写入器
+ *
+ * 构造时写出文件头，之后每轮直接从 TrafficRound 的数组写出，不做中间转换
+ */
+class TrafficTraceWriter {
+private:
+  std::ostream &out_;
+  size_t num_rounds_ = 0;
+
+public:
+  explicit TrafficTraceWriter(std::ostream &out);
+
+  // 写出一轮，数组长度与节点数不一致时抛出 std::invalid_argument
+  void write(const TrafficRound &round);
+
+  size_t num_rounds() const { return num_rounds_; }
+};
+
+/**
+ * @brief 把多轮流量写成二进制轨迹
+ * @param out 输出流
+ * @param rounds 多轮流量
+ */
+void write_traffic_trace(std::ostream &out,
+                         const std::vector<TrafficRound> &rounds);
+
+/**
+ * @brief 读取二进制轨迹
+ * @param in 输入流
+ * @return 多轮流量
+ *
+ * 文件头不正确、形状表与当前的 gemm_shapes() 不一致、记录不完整，
+ * 或记录中的下标、形状编号、接收偏移越界时抛出 std::runtime_error。
+ * 数组按块读取，损坏的长度字段不会导致按其大小分配内存
+ */
+std::vector<TrafficRound> read_traffic_trace(std::istream &in);